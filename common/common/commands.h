@@ -1,11 +1,67 @@
 #pragma once
 #include "group.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
 
 namespace fty {
 
 static constexpr const char* Channel = "FTY.Q.GROUP.QUERY";
 static constexpr const char* Events  = "FTY.Q.GROUP.EVENT";
 
+/// Error replied to a request which was not admitted by the server, the request could be retried later
+static constexpr const char* BusyError = "busy";
+
+namespace commands {
+    /// Order of items in paged answers: by `id` (default) or by `name`, `-` prefix is for descending order
+    struct Order
+    {
+        bool byName     = false;
+        bool descending = false;
+
+        /// Returns nullopt if the key is unknown
+        static std::optional<Order> parse(std::string_view key)
+        {
+            Order ret;
+            if (!key.empty() && key[0] == '-') {
+                ret.descending = true;
+                key.remove_prefix(1);
+            }
+            if (key == "id" || (key.empty() && !ret.descending)) {
+                return ret;
+            }
+            if (key == "name") {
+                ret.byName = true;
+                return ret;
+            }
+            return std::nullopt;
+        }
+
+        /// Returns true if the left item goes first, items with equal names are ordered by id
+        bool operator()(uint64_t lid, std::string_view lname, uint64_t rid, std::string_view rname) const
+        {
+            if (descending) {
+                std::swap(lid, rid);
+                std::swap(lname, rname);
+            }
+            if (byName && lname != rname) {
+                return lname < rname;
+            }
+            return lid < rid;
+        }
+    };
+
+    /// Returns true if the field is one of listed
+    inline bool contains(const pack::StringList& fields, std::string_view field)
+    {
+        return std::any_of(fields.begin(), fields.end(), [&](const std::string& it) {
+            return it == field;
+        });
+    }
+} // namespace commands
+
 namespace commands::create {
     static constexpr const char* Subject = "CREATE";
 
@@ -36,28 +92,83 @@ namespace commands::remove {
 namespace commands::resolve {
     static constexpr const char* Subject = "RESOLVE";
 
+    /// Returns true if the field could be requested in `fields`, id and name are always answered
+    inline bool isField(std::string_view field)
+    {
+        static constexpr std::string_view Fields[] = {
+            "id", "name", "type", "sub_type", "status", "priority", "locations", "powers", "ext"};
+        return std::find(std::begin(Fields), std::end(Fields), field) != std::end(Fields);
+    }
+
     struct Request : public pack::Node
     {
-        pack::UInt64 id = FIELD("id");
+        pack::UInt64     id      = FIELD("id");
+        pack::Bool       details = FIELD("details");
+        pack::String     sort    = FIELD("sort");   // see Order
+        pack::UInt32     offset  = FIELD("offset");
+        pack::UInt32     limit   = FIELD("limit");  // 0 is no limit
+        pack::StringList fields  = FIELD("fields"); // details to fill, all of them if empty
 
         using pack::Node::Node;
-        META(Request, id);
+        META(Request, id, details, sort, offset, limit, fields);
     };
 
-    struct Answer : public pack::Node
+    /// Asset referenced by the resolved one: its location or power source
+    struct Reference : public pack::Node
     {
         pack::UInt64 id   = FIELD("id");
         pack::String name = FIELD("name");
+        pack::String type = FIELD("type");
 
         using pack::Node::Node;
-        META(Answer, id, name);
+        META(Reference, id, name, type);
     };
 
+    /// Resolved asset, everything except id and name is filled only if details were requested
+    struct Answer : public pack::Node
+    {
+        pack::UInt64                id        = FIELD("id");
+        pack::String                name      = FIELD("name");
+        pack::String                type      = FIELD("type");
+        pack::String                subType   = FIELD("sub_type");
+        pack::String                status    = FIELD("status");
+        pack::UInt32                priority  = FIELD("priority");
+        pack::ObjectList<Reference> locations = FIELD("locations");
+        pack::ObjectList<Reference> powers    = FIELD("powers");
+        pack::StringMap             ext       = FIELD("ext");
+
+        using pack::Node::Node;
+        META(Answer, id, name, type, subType, status, priority, locations, powers, ext);
+    };
 
     using In  = Request;
     using Out = pack::ObjectList<Answer>;
 } // namespace commands::resolve
 
+namespace commands::resolveCount {
+    static constexpr const char* Subject = "RESOLVE_COUNT";
+
+    struct Request : public pack::Node
+    {
+        pack::UInt64 id = FIELD("id");
+
+        using pack::Node::Node;
+        META(Request, id);
+    };
+
+    /// Count of all assets of the group, pages of resolve answer are cut of them
+    struct Answer : public pack::Node
+    {
+        pack::UInt64 total = FIELD("total");
+
+        using pack::Node::Node;
+        META(Answer, total);
+    };
+
+    using In  = Request;
+    using Out = Answer;
+} // namespace commands::resolveCount
+
 namespace commands::list {
     static constexpr const char* Subject = "LIST";
 
@@ -70,6 +181,7 @@ namespace commands::list {
         META(Answer, id, name);
     };
 
+    using In  = void;
     using Out = pack::ObjectList<Answer>;
 } // namespace commands::list
 
@@ -88,11 +200,210 @@ namespace commands::read {
     using Out = Group;
 } // namespace commands::read
 
+namespace commands::readMany {
+    static constexpr const char* Subject = "READ_MANY";
+
+    /// Returns true if the field could be requested in `fields`, id and name are always answered
+    inline bool isField(std::string_view field)
+    {
+        return field == "id" || field == "name" || field == "rules";
+    }
+
+    /// Groups to read: all of them or the ones with listed ids. Groups with listed ids are answered in order of ids
+    /// unless `sort` is set.
+    struct Request : public pack::Node
+    {
+        pack::Bool       all    = FIELD("all");
+        pack::UInt64List ids    = FIELD("ids");
+        pack::String     sort   = FIELD("sort");   // see Order
+        pack::UInt32     offset = FIELD("offset");
+        pack::UInt32     limit  = FIELD("limit");  // 0 is no limit
+        pack::StringList fields = FIELD("fields"); // fields to answer, all of them if empty
+
+        using pack::Node::Node;
+        META(Request, all, ids, sort, offset, limit, fields);
+    };
+
+    using In  = Request;
+    using Out = pack::ObjectList<Group>;
+} // namespace commands::readMany
+
+namespace commands::membership {
+    static constexpr const char* Subject = "MEMBERSHIP_OF";
+
+    struct Request : public pack::Node
+    {
+        pack::UInt64 id = FIELD("id");
+
+        using pack::Node::Node;
+        META(Request, id);
+    };
+
+    struct Answer : public pack::Node
+    {
+        pack::UInt64 id   = FIELD("id");
+        pack::String name = FIELD("name");
+
+        using pack::Node::Node;
+        META(Answer, id, name);
+    };
+
+    using In  = Request;
+    using Out = pack::ObjectList<Answer>;
+} // namespace commands::membership
+
+namespace commands::stats {
+    static constexpr const char* Subject = "STATS";
+
+    /// Latencies of one stage of request processing, in microseconds
+    struct Stage : public pack::Node
+    {
+        pack::String name  = FIELD("name");
+        pack::UInt64 count = FIELD("count");
+        pack::UInt64 min   = FIELD("min");
+        pack::UInt64 mean  = FIELD("mean");
+        pack::UInt64 p50   = FIELD("p50");
+        pack::UInt64 p90   = FIELD("p90");
+        pack::UInt64 p99   = FIELD("p99");
+        pack::UInt64 p999  = FIELD("p99.9");
+        pack::UInt64 max   = FIELD("max");
+
+        using pack::Node::Node;
+        META(Stage, name, count, min, mean, p50, p90, p99, p999, max);
+    };
+
+    struct Answer : public pack::Node
+    {
+        pack::String            subject = FIELD("subject");
+        pack::ObjectList<Stage> stages  = FIELD("stages");
+
+        using pack::Node::Node;
+        META(Answer, subject, stages);
+    };
+
+    using In  = void;
+    using Out = pack::ObjectList<Answer>;
+} // namespace commands::stats
+
+namespace commands::version {
+    static constexpr const char* Subject = "VERSION";
+
+    /// State of the daemon data. Counters grow on every change, generation changes when the daemon is restarted.
+    /// `assets` counts processed asset events, `index` updates of the asset attributes index.
+    struct Answer : public pack::Node
+    {
+        pack::UInt64 generation = FIELD("generation");
+        pack::UInt64 groups     = FIELD("groups");
+        pack::UInt64 assets     = FIELD("assets");
+        pack::UInt64 index      = FIELD("index");
+
+        using pack::Node::Node;
+        META(Answer, generation, groups, assets, index);
+    };
+
+    using In  = void;
+    using Out = Answer;
+} // namespace commands::version
+
 namespace commands::notify {
     static constexpr const char* Created = "CREATED";
     static constexpr const char* Updated = "UPDATED";
     static constexpr const char* Deleted = "DELETED";
     using Payload                        = pack::UInt64;
+
+    /// Notifications coalesced within a time window into one message: ids of groups per event type
+    static constexpr const char* Batch = "BATCH";
+
+    struct BatchPayload : public pack::Node
+    {
+        pack::UInt64List created = FIELD("created");
+        pack::UInt64List updated = FIELD("updated");
+        pack::UInt64List deleted = FIELD("deleted");
+
+        using pack::Node::Node;
+        META(BatchPayload, created, updated, deleted);
+    };
 } // namespace commands::notify
 
+// =====================================================================================================================
+// Registry of request commands. Subject, request and response types of a command are bound here once, server dispatch
+// and client helpers are built from it, so they could not drift.
+
+namespace commands {
+    /// FNV-1a hash of a subject
+    constexpr uint64_t hash(std::string_view str)
+    {
+        uint64_t ret = 14695981039346656037ull;
+        for (char ch : str) {
+            ret = (ret ^ uint64_t(uint8_t(ch))) * 1099511628211ull;
+        }
+        return ret;
+    }
+
+    template <typename InT, typename OutT>
+    struct Command
+    {
+        using In  = InT;
+        using Out = OutT;
+    };
+
+    // clang-format off
+    struct Create       : Command<create::In, create::Out>             { static constexpr const char* Subject = create::Subject;       };
+    struct Update       : Command<update::In, update::Out>             { static constexpr const char* Subject = update::Subject;       };
+    struct Remove       : Command<remove::In, remove::Out>             { static constexpr const char* Subject = remove::Subject;       };
+    struct Resolve      : Command<resolve::In, resolve::Out>           { static constexpr const char* Subject = resolve::Subject;      };
+    struct ResolveCount : Command<resolveCount::In, resolveCount::Out> { static constexpr const char* Subject = resolveCount::Subject; };
+    struct List         : Command<list::In, list::Out>                 { static constexpr const char* Subject = list::Subject;         };
+    struct Read         : Command<read::In, read::Out>                 { static constexpr const char* Subject = read::Subject;         };
+    struct ReadMany     : Command<readMany::In, readMany::Out>         { static constexpr const char* Subject = readMany::Subject;     };
+    struct Membership   : Command<membership::In, membership::Out>     { static constexpr const char* Subject = membership::Subject;   };
+    struct Stats        : Command<stats::In, stats::Out>               { static constexpr const char* Subject = stats::Subject;        };
+    struct Version      : Command<version::In, version::Out>           { static constexpr const char* Subject = version::Subject;      };
+    // clang-format on
+
+    /// Set of commands with dispatch by subject. Subjects are hashed at compile time, so dispatch of a request costs
+    /// one hash of its subject, integer comparisons and one string comparison of the matched command.
+    template <typename... Cmds>
+    class Registry
+    {
+    public:
+        template <typename Cmd>
+        static constexpr uint64_t Key = hash(Cmd::Subject);
+
+        /// Calls `func(Cmd{})` for the command with the subject, returns false if the subject is unknown
+        template <typename Func>
+        static bool dispatch(std::string_view subject, Func&& func)
+        {
+            static_assert(unique(), "Subjects of commands must have different hashes");
+
+            const uint64_t key = hash(subject);
+            return ((key == Key<Cmds> && subject == Cmds::Subject && (func(Cmds{}), true)) || ...);
+        }
+
+        /// Calls `func(Cmd{})` for every command
+        template <typename Func>
+        static void forEach(Func&& func)
+        {
+            (func(Cmds{}), ...);
+        }
+
+    private:
+        static constexpr bool unique()
+        {
+            const uint64_t keys[] = {Key<Cmds>...};
+            for (size_t i = 0; i < sizeof...(Cmds); ++i) {
+                for (size_t j = i + 1; j < sizeof...(Cmds); ++j) {
+                    if (keys[i] == keys[j]) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    using All =
+        Registry<Create, Update, Remove, Resolve, ResolveCount, List, Read, ReadMany, Membership, Stats, Version>;
+} // namespace commands
+
 } // namespace fty
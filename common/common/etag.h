@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace fty::etag {
+
+/// Weak entity tag: the answer is semantically the same, but could lag behind the data it is built of
+inline std::string weak(const std::string& tag)
+{
+    return tag.empty() ? tag : "W/" + tag;
+}
+
+/// Returns true if `If-None-Match` header value lists the tag or is `*`. Tags are compared weakly, i.e. `W/` prefix is
+/// ignored on both sides. Empty tag never matches, an untagged answer is always sent.
+inline bool matches(std::string_view ifNoneMatch, std::string_view tag)
+{
+    auto strip = [](std::string_view str) {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+            str.remove_suffix(1);
+        }
+        if (str.substr(0, 2) == "W/") {
+            str.remove_prefix(2);
+        }
+        return str;
+    };
+
+    tag = strip(tag);
+    if (tag.empty()) {
+        return false;
+    }
+
+    while (!ifNoneMatch.empty()) {
+        auto pos  = ifNoneMatch.find(',');
+        auto item = strip(ifNoneMatch.substr(0, pos));
+        if (item == tag || item == "*") {
+            return true;
+        }
+        ifNoneMatch.remove_prefix(pos == std::string_view::npos ? ifNoneMatch.size() : pos + 1);
+    }
+    return false;
+}
+
+} // namespace fty::etag
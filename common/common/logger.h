@@ -3,17 +3,48 @@
 #include <fty/translate.h>
 #include <fty_log.h>
 
-#define logError(...) log(log4cplus::ERROR_LOG_LEVEL, __VA_ARGS__)
-#define logDebug(...) log(log4cplus::DEBUG_LOG_LEVEL, __VA_ARGS__)
-#define logInfo(...)  log(log4cplus::INFO_LOG_LEVEL, __VA_ARGS__)
-#define logWarn(...)  log(log4cplus::WARN_LOG_LEVEL, __VA_ARGS__)
-#define logFatal(...) log(log4cplus::FATAL_LOG_LEVEL, __VA_ARGS__)
+#define logError(...) logAt(log4cplus::ERROR_LOG_LEVEL, __VA_ARGS__)
+#define logDebug(...) logAt(log4cplus::DEBUG_LOG_LEVEL, __VA_ARGS__)
+#define logInfo(...)  logAt(log4cplus::INFO_LOG_LEVEL, __VA_ARGS__)
+#define logWarn(...)  logAt(log4cplus::WARN_LOG_LEVEL, __VA_ARGS__)
+#define logFatal(...) logAt(log4cplus::FATAL_LOG_LEVEL, __VA_ARGS__)
 
-#define log(level, ...)                                                                                                \
-    ftylog_getInstance()->insertLog(level, __FILE__, __LINE__, __func__, fty::logger::format(__VA_ARGS__).c_str())
+// Arguments are evaluated and formatted only if the level is enabled, the line is written by the background sink
+#define logAt(level, ...)                                                                                              \
+    do {                                                                                                               \
+        if (fty::logger::enabled(level)) {                                                                             \
+            fty::logger::write(level, __FILE__, __LINE__, __func__, fty::logger::format(__VA_ARGS__));                 \
+        }                                                                                                              \
+    } while (false)
 
 namespace fty::logger {
 
+inline bool enabled(log4cplus::LogLevel level)
+{
+    Ftylog* inst = ftylog_getInstance();
+    switch (level) {
+        case log4cplus::DEBUG_LOG_LEVEL:
+            return inst->isLogDebug();
+        case log4cplus::INFO_LOG_LEVEL:
+            return inst->isLogInfo();
+        case log4cplus::WARN_LOG_LEVEL:
+            return inst->isLogWarning();
+        case log4cplus::ERROR_LOG_LEVEL:
+            return inst->isLogError();
+        case log4cplus::FATAL_LOG_LEVEL:
+            return inst->isLogFatal();
+        default:
+            return true;
+    }
+}
+
+/// Queues the line into asynchronous ring-buffer sink, so the caller never waits for log4cplus I/O.
+/// If the buffer is full, the line is dropped and counted, dropped lines are reported by the sink later.
+void write(log4cplus::LogLevel level, const char* file, int line, const char* func, std::string&& message);
+
+/// Waits until all queued lines are written
+void flush();
+
 inline std::string format(const std::string& str)
 {
     return str;
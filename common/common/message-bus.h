@@ -21,15 +21,23 @@
 
 #pragma once
 #include "message.h"
+#include "mpsc-queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fty_common_messagebus_message.h>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 // =====================================================================================================================
 
 namespace messagebus {
 class MessageBus;
-class Message;
 } // namespace messagebus
 
 // =====================================================================================================================
@@ -37,10 +45,16 @@ class Message;
 namespace fty {
 
 /// Common message bus temporary wrapper
+/// Requests, replies and publications are put into outbound queue and written by dedicated bus I/O thread, so callers
+/// never wait for the bus. Write errors are logged by I/O thread.
+/// Replies are matched to requests by correlation id, so any number of requests could be in flight on one connection.
 class MessageBus
 {
 public:
-    static constexpr const char* endpoint = "ipc://@/malamute";
+    static constexpr const char*               endpoint       = "ipc://@/malamute";
+    static constexpr std::chrono::milliseconds DefaultTimeout = std::chrono::milliseconds(10000);
+    /// Connection which timed out this many requests in a row without any reply is considered broken
+    static constexpr size_t MaxTimeouts = 3;
 
 public:
     MessageBus();
@@ -48,26 +62,61 @@ public:
 
     [[nodiscard]] Expected<void> init(const std::string& actorName);
 
+    /// False if the bus was not initialized, writing to it failed or `MaxTimeouts` requests in a row timed out, such
+    /// connection should be made again
+    bool connected() const;
+
     [[nodiscard]] Expected<Message> send(const std::string& queue, const Message& msg);
+    [[nodiscard]] std::future<Expected<Message>> sendAsync(
+        const std::string& queue, const Message& msg, std::chrono::milliseconds timeout = DefaultTimeout);
     [[nodiscard]] Expected<void>    publish(const std::string& queue, const Message& msg);
     [[nodiscard]] Expected<void>    reply(const std::string& queue, const Message& req, const Message& answ);
+    /// Same as above, but payload of the answer is moved into the outbound queue
+    [[nodiscard]] Expected<void>    reply(const std::string& queue, const Message& req, Message&& answ);
     [[nodiscard]] Expected<Message> recieve(const std::string& queue);
 
     template <typename Func, typename Cls>
     [[nodiscard]] Expected<void> subsribe(const std::string& queue, Func&& fnc, Cls* cls)
     {
-        return subsribe(queue, [f = std::move(fnc), c = cls](const messagebus::Message& msg) -> void {
-            std::invoke(f, *c, Message(msg));
+        return subsribe(queue, [f = std::move(fnc), c = cls](messagebus::Message msg) -> void {
+            std::invoke(f, *c, Message(std::move(msg)));
         });
     }
 
 private:
-    Expected<void> subsribe(const std::string& queue, std::function<void(const messagebus::Message&)>&& func);
+    struct Outbound;
+
+    struct Request
+    {
+        std::promise<Expected<Message>>       promise;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    Expected<void> subsribe(const std::string& queue, std::function<void(messagebus::Message)>&& func);
+    Expected<void> enqueue(Outbound&& out);
+    void           ioLoop();
+    Expected<void> listen(const std::string& queue);
+    void           onReply(messagebus::Message&& msg);
+    void           complete(const std::string& correlationId, Expected<Message>&& result);
+    void           expire(bool all);
 
 private:
     std::unique_ptr<messagebus::MessageBus> m_bus;
     std::mutex                              m_mutex;
     std::string                             m_actorName;
+
+    MpscQueue<Outbound>     m_outbound;
+    std::atomic<size_t>     m_pending  = 0;
+    std::atomic<bool>       m_stop     = false;
+    std::atomic<bool>       m_broken   = false;
+    std::atomic<size_t>     m_timeouts = 0; // requests timed out since the last reply
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wake;
+    std::thread             m_ioThread;
+
+    std::mutex                               m_requestsMutex;
+    std::unordered_map<std::string, Request> m_requests;
+    std::set<std::string>                    m_replyQueues;
 };
 
 } // namespace fty
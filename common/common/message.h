@@ -20,6 +20,7 @@
 */
 
 #pragma once
+#include <fty/expected.h>
 #include <pack/pack.h>
 
 // =====================================================================================================================
@@ -42,6 +43,15 @@ public:
         Error
     };
 
+    /// Encoding of the payload. Json is default, so peers which do not know `encoding` meta field keep working.
+    enum class Encoding
+    {
+        Json,
+        Binary // protobuf wire format produced by pack
+    };
+
+    static constexpr const char* EncodingKey = "encoding";
+
     struct Meta : public pack::Node
     {
         pack::String         replyTo       = FIELD("reply-to");
@@ -51,9 +61,10 @@ public:
         pack::Enum<Status>   status        = FIELD("status");
         pack::String         timeout       = FIELD("timeout");
         mutable pack::String correlationId = FIELD("correlation-id");
+        pack::Enum<Encoding> encoding      = FIELD(EncodingKey);
 
         using pack::Node::Node;
-        META(Meta, replyTo, from, to, subject, status, timeout, correlationId);
+        META(Meta, replyTo, from, to, subject, status, timeout, correlationId, encoding);
     };
 
 public:
@@ -66,7 +77,38 @@ public:
 
 public:
     explicit Message(const messagebus::Message& msg);
-    messagebus::Message toMessageBus() const;
+    /// Takes over payload and meta data of bus message without copying them
+    explicit Message(messagebus::Message&& msg);
+    messagebus::Message toMessageBus() const&;
+    /// Hands payload over to the bus message without copying it
+    messagebus::Message toMessageBus() &&;
+
+    /// Decodes payload according to the encoding declared in meta data
+    template <typename T>
+    Expected<T> decode() const
+    {
+        if (meta.encoding == Encoding::Binary) {
+            T ret;
+            if (auto res = pack::protobuf::deserialize(userData.asString(), ret); !res) {
+                return unexpected(res.error());
+            }
+            return ret;
+        }
+        return userData.decode<T>();
+    }
+
+    /// Encodes payload and declares the encoding in meta data
+    template <typename T>
+    Expected<void> encode(const T& value, Encoding encoding = Encoding::Json)
+    {
+        auto data = encoding == Encoding::Binary ? pack::protobuf::serialize(value) : pack::json::serialize(value);
+        if (!data) {
+            return unexpected(data.error());
+        }
+        userData.setString(*data);
+        meta.encoding = encoding;
+        return {};
+    }
 };
 
 inline std::ostream& operator<<(std::ostream& ss, Message::Status status)
@@ -94,6 +136,31 @@ inline std::istream& operator>>(std::istream& ss, Message::Status& status)
     return ss;
 }
 
+inline std::ostream& operator<<(std::ostream& ss, Message::Encoding encoding)
+{
+    switch (encoding) {
+    case Message::Encoding::Json:
+        ss << "json";
+        break;
+    case Message::Encoding::Binary:
+        ss << "binary";
+        break;
+    }
+    return ss;
+}
+
+inline std::istream& operator>>(std::istream& ss, Message::Encoding& encoding)
+{
+    std::string str;
+    ss >> str;
+    if (str == "binary") {
+        encoding = Message::Encoding::Binary;
+    } else {
+        encoding = Message::Encoding::Json;
+    }
+    return ss;
+}
+
 } // namespace fty
 
 // =====================================================================================================================
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <optional>
+
+namespace fty {
+
+/// Unbounded lock-free multi-producer single-consumer queue (intrusive Vyukov queue).
+/// Push never blocks and could be called from any thread, pop must be called from one consumer thread only.
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : m_head(new Node)
+        , m_tail(m_head.load())
+    {
+    }
+
+    ~MpscQueue()
+    {
+        while (pop()) {
+        }
+        delete m_tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T&& value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /// Returns nullopt if queue is empty or producer did not finish push yet
+    std::optional<T> pop()
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+
+        std::optional<T> ret = std::move(next->value);
+        next->value.reset();
+        m_tail = next;
+        delete tail;
+        return ret;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+        Node(T&& val)
+            : value(std::move(val))
+        {
+        }
+
+        std::atomic<Node*> next = nullptr;
+        std::optional<T>   value;
+    };
+
+private:
+    std::atomic<Node*> m_head;
+    Node*              m_tail;
+};
+
+} // namespace fty
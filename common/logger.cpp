@@ -0,0 +1,171 @@
+#include "common/logger.h"
+#include "common/ring-buffer.h"
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <thread>
+
+namespace fty::logger {
+
+// =====================================================================================================================
+
+struct Line
+{
+    log4cplus::LogLevel level = log4cplus::DEBUG_LOG_LEVEL;
+    const char*         file  = nullptr;
+    int                 line  = 0;
+    const char*         func  = nullptr;
+    std::string         message;
+};
+
+/// Background writer of log lines. Producers only put lines into ring buffer, log4cplus is called from sink thread.
+class Sink
+{
+public:
+    static constexpr size_t Capacity = 16384;
+
+    static Sink& instance()
+    {
+        static Sink inst;
+        return inst;
+    }
+
+    Sink()
+        : m_buffer(std::make_unique<RingBuffer<Line>>(Capacity))
+    {
+        // Only the forking thread survives fork (daemonize). Sink thread is gone, and it or another thread could have
+        // held the mutex, waited on the condition or claimed a cell of the buffer, so the child gets fresh ones. Old
+        // ones are left as they are, they could not be destroyed safely. Child starts new thread on the first line.
+        pthread_atfork(nullptr, nullptr, []() {
+            auto& sink = Sink::instance();
+            sink.m_thread.release();
+            sink.m_buffer.release();
+            sink.m_buffer = std::make_unique<RingBuffer<Line>>(Capacity);
+            new (&sink.m_mutex) std::mutex;
+            new (&sink.m_wake) std::condition_variable;
+            sink.m_running  = false;
+            sink.m_sleeping = false;
+            sink.m_stop     = false;
+            sink.m_queued   = 0;
+            sink.m_written  = 0;
+            sink.m_dropped  = 0;
+        });
+    }
+
+    ~Sink()
+    {
+        stop();
+    }
+
+    void push(Line&& line)
+    {
+        start();
+
+        if (!m_buffer->push(std::move(line))) {
+            ++m_dropped;
+            return;
+        }
+        ++m_queued;
+
+        // Sink registers itself as sleeping before it checks queued lines, so one of both sides sees the other
+        if (m_sleeping) {
+            { std::lock_guard<std::mutex> lock(m_mutex); }
+            m_wake.notify_one();
+        }
+    }
+
+    void flush()
+    {
+        uint64_t queued = m_queued;
+        while (m_running && m_written < queued) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+private:
+    void start()
+    {
+        if (m_running) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            m_stop    = false;
+            m_thread  = std::make_unique<std::thread>(&Sink::run, this);
+            m_running = true;
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        if (m_thread && m_thread->joinable()) {
+            m_thread->join();
+        }
+        m_running = false;
+    }
+
+    void run()
+    {
+        while (true) {
+            while (auto line = m_buffer->pop()) {
+                ftylog_getInstance()->insertLog(line->level, line->file, line->line, line->func, "%s",
+                    line->message.c_str());
+                ++m_written;
+            }
+
+            if (uint64_t dropped = m_dropped.exchange(0)) {
+                std::string msg = fmt::format("Logger: {} lines were dropped, log buffer is full", dropped);
+                ftylog_getInstance()->insertLog(log4cplus::WARN_LOG_LEVEL, __FILE__, __LINE__, __func__, "%s",
+                    msg.c_str());
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping = true;
+            m_wake.wait(lock, [&]() {
+                return m_stop || m_written < m_queued;
+            });
+            m_sleeping = false;
+
+            if (m_stop && m_written >= m_queued) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::unique_ptr<RingBuffer<Line>> m_buffer;
+    std::unique_ptr<std::thread>      m_thread;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_wake;
+    std::atomic<bool>                 m_running  = false;
+    std::atomic<bool>                 m_sleeping = false;
+    std::atomic<bool>                 m_stop     = false;
+    std::atomic<uint64_t>             m_queued   = 0;
+    std::atomic<uint64_t>             m_written  = 0;
+    std::atomic<uint64_t>             m_dropped  = 0;
+};
+
+// =====================================================================================================================
+
+void write(log4cplus::LogLevel level, const char* file, int line, const char* func, std::string&& message)
+{
+    Sink::instance().push({level, file, line, func, std::move(message)});
+
+    // Process is most probably going down, line should not be lost
+    if (level >= log4cplus::FATAL_LOG_LEVEL) {
+        flush();
+    }
+}
+
+void flush()
+{
+    Sink::instance().flush();
+}
+
+} // namespace fty::logger
@@ -20,6 +20,7 @@
  */
 
 #include "common/message-bus.h"
+#include "common/logger.h"
 #include <fty_log.h>
 #include <fty_common_messagebus_exception.h>
 #include <fty_common_messagebus_interface.h>
@@ -27,6 +28,24 @@
 
 namespace fty {
 
+// =====================================================================================================================
+
+struct MessageBus::Outbound
+{
+    enum class Type
+    {
+        Publish,
+        Reply,
+        Request
+    };
+
+    Type                type;
+    std::string         queue;
+    messagebus::Message msg;
+};
+
+// =====================================================================================================================
+
 MessageBus::MessageBus() = default;
 
 Expected<void> MessageBus::init(const std::string& actorName)
@@ -36,6 +55,7 @@ Expected<void> MessageBus::init(const std::string& actorName)
         m_bus = std::unique_ptr<messagebus::MessageBus>(messagebus::MlmMessageBus(endpoint, actorName));
         m_bus->connect();
         m_actorName = actorName;
+        m_ioThread  = std::thread(&MessageBus::ioLoop, this);
         return {};
     } catch (std::exception& ex) {
         return unexpected(ex.what());
@@ -44,52 +64,88 @@ Expected<void> MessageBus::init(const std::string& actorName)
 
 MessageBus::~MessageBus()
 {
+    if (m_ioThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_ioThread.join();
+    }
+    // Stop bus listener before pending requests are gone
+    m_bus.reset();
+    expire(true);
+}
+
+bool MessageBus::connected() const
+{
+    return m_ioThread.joinable() && !m_stop && !m_broken;
 }
 
 Expected<Message> MessageBus::send(const std::string& queue, const Message& msg)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    return sendAsync(queue, msg).get();
+}
+
+std::future<Expected<Message>> MessageBus::sendAsync(
+    const std::string& queue, const Message& msg, std::chrono::milliseconds timeout)
+{
+    std::promise<Expected<Message>> promise;
+    auto                            ret = promise.get_future();
+
+    if (auto res = listen(queue); !res) {
+        promise.set_value(unexpected(res.error()));
+        return ret;
+    }
+
     if (msg.meta.correlationId.empty()) {
         msg.meta.correlationId = messagebus::generateUuid();
     }
     msg.meta.from = m_actorName;
-    try {
-        Message m(m_bus->request(queue, msg.toMessageBus(), 10000));
-        if (m.meta.status == Message::Status::Error) {
-            return unexpected(*m.userData.decode<std::string>());
+
+    auto out = msg.toMessageBus();
+    if (out.metaData()[messagebus::Message::REPLY_TO].empty()) {
+        out.metaData()[messagebus::Message::REPLY_TO] = queue;
+    }
+
+    {
+        auto                        deadline = std::chrono::steady_clock::now() + timeout;
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+        if (m_requests.count(msg.meta.correlationId.value())) {
+            promise.set_value(unexpected("Request '{}' is already in flight", msg.meta.correlationId.value()));
+            return ret;
         }
-        return Expected<Message>(m);
-    } catch (messagebus::MessageBusException& ex) {
-        return unexpected(ex.what());
+        m_requests.emplace(msg.meta.correlationId.value(), Request{std::move(promise), deadline});
+    }
+
+    if (auto res = enqueue({Outbound::Type::Request, queue, std::move(out)}); !res) {
+        complete(msg.meta.correlationId, unexpected(res.error()));
     }
+    return ret;
 }
 
 Expected<void> MessageBus::publish(const std::string& queue, const Message& msg)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
     msg.meta.from = m_actorName;
-    try {
-        m_bus->publish(queue, msg.toMessageBus());
-    } catch (messagebus::MessageBusException& ex) {
-        return unexpected(ex.what());
-    }
-    return {};
+    return enqueue({Outbound::Type::Publish, queue, msg.toMessageBus()});
 }
 
 Expected<void> MessageBus::reply(const std::string& queue, const Message& req, const Message& answ)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    answ.meta.correlationId = req.meta.correlationId;
+    answ.meta.to            = req.meta.from;
+    answ.meta.from          = req.meta.to;
+
+    return enqueue({Outbound::Type::Reply, queue, answ.toMessageBus()});
+}
 
+Expected<void> MessageBus::reply(const std::string& queue, const Message& req, Message&& answ)
+{
     answ.meta.correlationId = req.meta.correlationId;
     answ.meta.to            = req.meta.from;
     answ.meta.from          = req.meta.to;
 
-    try {
-        m_bus->sendReply(queue, answ.toMessageBus());
-        return {};
-    } catch (messagebus::MessageBusException& ex) {
-        return unexpected(ex.what());
-    }
+    return enqueue({Outbound::Type::Reply, queue, std::move(answ).toMessageBus()});
 }
 
 Expected<Message> MessageBus::recieve(const std::string& queue)
@@ -106,15 +162,166 @@ Expected<Message> MessageBus::recieve(const std::string& queue)
     }
 }
 
-Expected<void> MessageBus::subsribe(const std::string& queue, std::function<void(const messagebus::Message&)>&& func)
+Expected<void> MessageBus::subsribe(const std::string& queue, std::function<void(messagebus::Message)>&& func)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     try {
-        m_bus->subscribe(queue, func);
+        m_bus->subscribe(queue, std::move(func));
         return {};
     } catch (messagebus::MessageBusException& ex) {
         return unexpected(ex.what());
     }
 }
 
+Expected<void> MessageBus::enqueue(Outbound&& out)
+{
+    if (!m_ioThread.joinable() || m_stop) {
+        return unexpected("Message bus is not connected");
+    }
+
+    m_outbound.push(std::move(out));
+
+    // Only the first message after the queue was drained has to wake up I/O thread
+    if (m_pending.fetch_add(1) == 0) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+    return {};
+}
+
+void MessageBus::ioLoop()
+{
+    // Requests in flight are checked for timeout at least this often
+    static constexpr auto ExpireTick = std::chrono::milliseconds(100);
+
+    while (true) {
+        bool inFlight;
+        {
+            std::lock_guard<std::mutex> lock(m_requestsMutex);
+            inFlight = !m_requests.empty();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            auto                         ready = [&]() {
+                return m_pending > 0 || m_stop;
+            };
+            if (inFlight) {
+                m_wake.wait_for(lock, ExpireTick, ready);
+            } else {
+                m_wake.wait(lock, ready);
+            }
+            if (m_pending == 0 && m_stop) {
+                break;
+            }
+        }
+
+        while (m_pending > 0) {
+            auto out = m_outbound.pop();
+            if (!out) {
+                // Producer is in the middle of push
+                std::this_thread::yield();
+                continue;
+            }
+
+            try {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (out->type == Outbound::Type::Publish) {
+                    m_bus->publish(out->queue, out->msg);
+                } else if (out->type == Outbound::Type::Request) {
+                    m_bus->sendRequest(out->queue, out->msg);
+                } else {
+                    m_bus->sendReply(out->queue, out->msg);
+                }
+            } catch (messagebus::MessageBusException& ex) {
+                logError("Cannot write message to '{}': {}", out->queue, ex.what());
+                m_broken = true;
+                if (out->type == Outbound::Type::Request) {
+                    complete(out->msg.metaData()[messagebus::Message::CORRELATION_ID], unexpected(ex.what()));
+                }
+            }
+            --m_pending;
+        }
+
+        expire(false);
+    }
+}
+
+Expected<void> MessageBus::listen(const std::string& queue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_bus) {
+        return unexpected("Message bus is not connected");
+    }
+    if (m_replyQueues.count(queue)) {
+        return {};
+    }
+
+    try {
+        m_bus->receive(queue, [this](messagebus::Message msg) {
+            onReply(std::move(msg));
+        });
+        m_replyQueues.insert(queue);
+        return {};
+    } catch (messagebus::MessageBusException& ex) {
+        return unexpected(ex.what());
+    }
+}
+
+void MessageBus::onReply(messagebus::Message&& msg)
+{
+    // Any reply, even a late one, proves the connection works
+    m_timeouts = 0;
+
+    Message reply(std::move(msg));
+    if (reply.meta.status == Message::Status::Error) {
+        complete(reply.meta.correlationId, unexpected(*reply.userData.decode<std::string>()));
+    } else {
+        complete(reply.meta.correlationId, std::move(reply));
+    }
+}
+
+void MessageBus::complete(const std::string& correlationId, Expected<Message>&& result)
+{
+    std::unique_lock<std::mutex> lock(m_requestsMutex);
+    auto                         it = m_requests.find(correlationId);
+    if (it == m_requests.end()) {
+        // Reply came after timeout
+        logDebug("Unexpected reply with correlation id '{}'", correlationId);
+        return;
+    }
+    auto promise = std::move(it->second.promise);
+    m_requests.erase(it);
+    lock.unlock();
+
+    promise.set_value(std::move(result));
+}
+
+void MessageBus::expire(bool all)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    std::vector<std::promise<Expected<Message>>> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+        for (auto it = m_requests.begin(); it != m_requests.end();) {
+            if (all || it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.promise));
+                it = m_requests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Malamute client does not notice a lost broker, so requests which keep timing out are the only sign of it
+    if (!all && !expired.empty() && (m_timeouts += expired.size()) >= MaxTimeouts && !m_broken.exchange(true)) {
+        logError("{} requests in a row timed out, connection '{}' is broken", m_timeouts.load(), m_actorName);
+    }
+
+    for (auto& promise : expired) {
+        promise.set_value(unexpected(all ? "Message bus is closed" : "Request timed out"));
+    }
+}
+
 } // namespace fty
@@ -33,12 +33,11 @@ struct identify
 };
 
 template <typename K, typename V>
-static V value(
-    const std::map<K, V>& map, const typename identify<K>::type& key, const typename identify<V>::type& def = {})
+static V take(std::map<K, V>& map, const typename identify<K>::type& key, const typename identify<V>::type& def = {})
 {
     auto it = map.find(key);
     if (it != map.end()) {
-        return it->second;
+        return std::move(it->second);
     }
     return def;
 }
@@ -46,28 +45,32 @@ static V value(
 // ===========================================================================================================
 
 Message::Message(const messagebus::Message& msg)
+    : Message(messagebus::Message(msg))
+{
+}
+
+Message::Message(messagebus::Message&& msg)
     : pack::Node::Node()
 {
-    meta.to            = value(msg.metaData(), messagebus::Message::TO);
-    meta.from          = value(msg.metaData(), messagebus::Message::FROM);
-    meta.replyTo       = value(msg.metaData(), messagebus::Message::REPLY_TO);
-    meta.subject       = value(msg.metaData(), messagebus::Message::SUBJECT);
-    meta.timeout       = value(msg.metaData(), messagebus::Message::TIMEOUT);
-    meta.correlationId = value(msg.metaData(), messagebus::Message::CORRELATION_ID);
+    auto& metaData = msg.metaData();
 
-    meta.status.fromString(value(msg.metaData(), messagebus::Message::STATUS, "ok"));
+    meta.to            = take(metaData, messagebus::Message::TO);
+    meta.from          = take(metaData, messagebus::Message::FROM);
+    meta.replyTo       = take(metaData, messagebus::Message::REPLY_TO);
+    meta.subject       = take(metaData, messagebus::Message::SUBJECT);
+    meta.timeout       = take(metaData, messagebus::Message::TIMEOUT);
+    meta.correlationId = take(metaData, messagebus::Message::CORRELATION_ID);
+
+    meta.status.fromString(take(metaData, messagebus::Message::STATUS, "ok"));
+    meta.encoding.fromString(take(metaData, EncodingKey, "json"));
 
     if (!msg.userData().empty()) {
-        userData.setString(msg.userData().front());
+        userData.setString(std::move(msg.userData().front()));
     }
 }
 
-messagebus::Message Message::toMessageBus() const
+static void setMeta(messagebus::Message& msg, const Message::Meta& meta)
 {
-    messagebus::Message msg;
-
-    msg.userData().emplace_back(userData.asString());
-
     msg.metaData()[messagebus::Message::TO]             = meta.to;
     msg.metaData()[messagebus::Message::FROM]           = meta.from;
     msg.metaData()[messagebus::Message::REPLY_TO]       = meta.replyTo;
@@ -75,7 +78,22 @@ messagebus::Message Message::toMessageBus() const
     msg.metaData()[messagebus::Message::TIMEOUT]        = meta.timeout;
     msg.metaData()[messagebus::Message::CORRELATION_ID] = meta.correlationId;
     msg.metaData()[messagebus::Message::STATUS]         = meta.status.asString();
+    msg.metaData()[Message::EncodingKey]                = meta.encoding.asString();
+}
 
+messagebus::Message Message::toMessageBus() const&
+{
+    messagebus::Message msg;
+    msg.userData().emplace_back(userData.asString());
+    setMeta(msg, meta);
+    return msg;
+}
+
+messagebus::Message Message::toMessageBus() &&
+{
+    messagebus::Message msg;
+    msg.userData().emplace_back(std::move(userData).asString());
+    setMeta(msg, meta);
     return msg;
 }
 
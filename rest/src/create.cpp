@@ -2,6 +2,7 @@
 #include <fty/rest/component.h>
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 #include "common/commands.h"
 
 namespace fty::agroup {
@@ -18,23 +19,25 @@ unsigned Create::run()
         throw rest::errors::BadInput("Group payload is empty");
     }
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
+    fty::MessageBus& bus = **conn;
 
-    auto msg = message(commands::create::Subject);
-    msg.userData.setString(json);
+    commands::create::In group;
+    if (auto ret = pack::json::deserialize(json, group); !ret) {
+        throw rest::errors::BadInput(ret.error());
+    }
 
-    if (auto ret = bus.send(fty::Channel, msg)) {
-        if (auto info = ret->userData.decode<fty::commands::create::Out>()) {
-            m_reply << *pack::json::serialize(*info);
-            return HTTP_OK;
-        } else {
-            throw rest::errors::Internal(info.error());
-        }
+    if (auto info = request<commands::Create>(bus, group)) {
+        versionChanged();
+        m_reply << *pack::json::serialize(*info);
+        return HTTP_OK;
+    } else if (isBusy(info.error())) {
+        return busy(m_reply);
     } else {
-        throw rest::errors::Internal(ret.error());
+        throw rest::errors::Internal(info.error());
     }
 }
 
@@ -2,6 +2,7 @@
 #include <fty/rest/component.h>
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 #include "common/commands.h"
 
 namespace fty::agroup {
@@ -30,23 +31,20 @@ unsigned Edit::run()
 
     group.id = fty::convert<uint64_t>(*strIdPrt);
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
-
-    auto msg = message(commands::update::Subject);
-    msg.userData.setString(*pack::json::serialize(group));
-
-    if (auto ret = bus.send(fty::Channel, msg)) {
-        if (auto info = ret->userData.decode<fty::commands::update::Out>()) {
-            m_reply << *pack::json::serialize(*info);
-            return HTTP_OK;
-        } else {
-            throw rest::errors::Internal(info.error());
-        }
+    fty::MessageBus& bus = **conn;
+
+    if (auto info = request<commands::Update>(bus, group)) {
+        versionChanged();
+        m_reply << *pack::json::serialize(*info);
+        return HTTP_OK;
+    } else if (isBusy(info.error())) {
+        return busy(m_reply);
     } else {
-        throw rest::errors::Internal(ret.error());
+        throw rest::errors::Internal(info.error());
     }
 
     return HTTP_OK;
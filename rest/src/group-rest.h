@@ -1,10 +1,25 @@
 #pragma once
+#include "common/commands.h"
+#include "common/etag.h"
+#include "common/message-bus.h"
 #include "common/message.h"
+#include <algorithm>
+#include <chrono>
+#include <fty/rest/runner.h>
+#include <fty/split.h>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <tnt/http.h>
+#include <tnt/httpreply.h>
 
 namespace fty::agroup {
 
-static constexpr const char* AgentName = "automatic_group_rest";
+static constexpr const char* AgentName  = "automatic_group_rest";
+static constexpr const char* RetryAfter = "1"; // seconds
 
+/// State of the daemon data is asked at most once per this time, see dataVersion()
+static constexpr std::chrono::milliseconds VersionTtl{1000};
 
 inline fty::Message message(const std::string& subj)
 {
@@ -15,4 +30,210 @@ inline fty::Message message(const std::string& subj)
     return msg;
 }
 
+/// Sends request of the command without waiting for the reply. Request and reply types are the ones registered for
+/// the command in the command registry.
+template <typename Cmd>
+std::future<Expected<typename Cmd::Out>> requestAsync(
+    fty::MessageBus& bus, const typename Cmd::In& in, Message::Encoding encoding = Message::Encoding::Json)
+{
+    fty::Message msg = message(Cmd::Subject);
+    if (auto res = msg.encode(in, encoding); !res) {
+        std::promise<Expected<typename Cmd::Out>> failed;
+        failed.set_value(unexpected(res.error()));
+        return failed.get_future();
+    }
+
+    auto reply = bus.sendAsync(fty::Channel, msg);
+    return std::async(std::launch::deferred, [reply = std::move(reply)]() mutable -> Expected<typename Cmd::Out> {
+        auto ret = reply.get();
+        if (!ret) {
+            return unexpected(ret.error());
+        }
+        return ret->template decode<typename Cmd::Out>();
+    });
+}
+
+/// Sends request of the command and waits for the reply
+template <typename Cmd>
+Expected<typename Cmd::Out> request(
+    fty::MessageBus& bus, const typename Cmd::In& in, Message::Encoding encoding = Message::Encoding::Json)
+{
+    return requestAsync<Cmd>(bus, in, encoding).get();
+}
+
+/// Sends request of the command which has no input and waits for the reply
+template <typename Cmd>
+Expected<typename Cmd::Out> request(fty::MessageBus& bus)
+{
+    static_assert(std::is_same_v<typename Cmd::In, void>, "Command requires input");
+
+    auto ret = bus.send(fty::Channel, message(Cmd::Subject));
+    if (!ret) {
+        return unexpected(ret.error());
+    }
+    return ret->template decode<typename Cmd::Out>();
+}
+
+/// Server did not admit the request, it should be retried later
+inline bool isBusy(const std::string& error)
+{
+    return error == fty::BusyError;
+}
+
+/// Answers 503 with Retry-After to the busy server reply
+inline unsigned busy(tnt::HttpReply& reply)
+{
+    reply.setHeader("Retry-After", RetryAfter);
+    return HTTP_SERVICE_UNAVAILABLE;
+}
+
+/// Paging and projection of list answers: `limit`, `offset`, `sort` and comma separated `fields` query parameters.
+/// They are passed to the daemon, so only the requested part of the list is read and sent.
+struct Page
+{
+    uint32_t                 limit  = 0; // 0 is no limit
+    uint32_t                 offset = 0;
+    std::string              sort;
+    std::vector<std::string> fields;
+
+    /// Reads parameters of the request, `isField` tells if a field name is known
+    template <typename Request, typename IsField>
+    static Page parse(const Request& request, IsField&& isField)
+    {
+        Page page;
+        if (auto limit = request.template queryArg<std::string>("limit")) {
+            page.limit = number("limit", *limit);
+        }
+        if (auto offset = request.template queryArg<std::string>("offset")) {
+            page.offset = number("offset", *offset);
+        }
+        if (auto sort = request.template queryArg<std::string>("sort")) {
+            if (!commands::Order::parse(*sort)) {
+                throw rest::errors::RequestParamBad("sort", *sort, "'id', 'name', '-id' or '-name'");
+            }
+            page.sort = *sort;
+        }
+        if (auto fields = request.template queryArg<std::string>("fields")) {
+            for (const auto& field : fty::split(*fields, ",")) {
+                if (!isField(field)) {
+                    throw rest::errors::RequestParamBad("fields", field, "name of a field");
+                }
+                page.fields.push_back(field);
+            }
+        }
+        return page;
+    }
+
+    /// Sets paging of the daemon request
+    template <typename In>
+    void apply(In& in) const
+    {
+        in.limit  = limit;
+        in.offset = offset;
+        in.sort   = sort;
+        for (const auto& field : fields) {
+            in.fields.append(field);
+        }
+    }
+
+private:
+    static uint32_t number(const std::string& name, const std::string& value)
+    {
+        auto digit = [](char ch) {
+            return ch >= '0' && ch <= '9';
+        };
+        if (value.empty() || value.size() > 9 || !std::all_of(value.begin(), value.end(), digit)) {
+            throw rest::errors::RequestParamBad(name, value, "non-negative number");
+        }
+        return uint32_t(std::stoul(value));
+    }
+};
+
+namespace detail {
+    struct VersionCache
+    {
+        std::mutex                            mutex;
+        std::optional<commands::version::Out> version;
+        std::chrono::steady_clock::time_point time;
+        uint64_t                              changes = 0;
+    };
+
+    inline VersionCache& versionCache()
+    {
+        static VersionCache cache;
+        return cache;
+    }
+} // namespace detail
+
+/// Drops the cached state of the daemon data, called after a change made by this process
+inline void versionChanged()
+{
+    auto&                       cache = detail::versionCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.version.reset();
+    ++cache.changes;
+}
+
+/// Returns state of the daemon data. It is shared by all requests of the process and asked again once it is older than
+/// `VersionTtl`, so a request does not pay for its own VERSION round trip.
+inline Expected<commands::version::Out> dataVersion(fty::MessageBus& bus)
+{
+    auto&    cache = detail::versionCache();
+    auto     now   = std::chrono::steady_clock::now();
+    uint64_t changes;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.version && now - cache.time < VersionTtl) {
+            return *cache.version;
+        }
+        changes = cache.changes;
+    }
+
+    auto version = request<commands::Version>(bus);
+    if (version) {
+        // Answer which was asked before a change of this process is not cached, it's already outdated
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        if (cache.changes == changes) {
+            cache.version = *version;
+            cache.time    = now;
+        }
+    }
+    return version;
+}
+
+/// Entity tag of the current state of the daemon data. Answers built of assets (`withAssets`) depend on asset data
+/// too. Returns empty tag if the state is unknown, such answer is not tagged.
+/// Tag must be taken before the data is read, so an answer is never tagged newer than its data.
+/// Tag could lag behind the data for `VersionTtl` after a change made by other process. Asset counters are bumped when
+/// the daemon processes asset events, which come asynchronously, so the tag of answers built of assets is weak: it
+/// could lag behind the asset database for the time of processing of the events as well.
+inline std::string etag(fty::MessageBus& bus, bool withAssets)
+{
+    auto version = dataVersion(bus);
+    if (!version) {
+        return {};
+    }
+
+    std::string tag = "\"" + std::to_string(version->generation.value());
+    tag += "-" + std::to_string(version->groups.value());
+    if (withAssets) {
+        tag += "-" + std::to_string(version->assets.value());
+        tag += "-" + std::to_string(version->index.value());
+        return etag::weak(tag + "\"");
+    }
+    return tag + "\"";
+}
+
+/// Sets ETag of the answer, returns true if the client already has it (`If-None-Match`), 304 should be answered then
+inline bool notModified(const std::string& ifNoneMatch, tnt::HttpReply& reply, const std::string& tag)
+{
+    if (tag.empty()) {
+        return false;
+    }
+    reply.setHeader("ETag", tag);
+
+    // Weak comparison, the answers are only compared for caching
+    return etag::matches(ifNoneMatch, tag);
+}
+
 }
@@ -5,6 +5,7 @@
 #include "common/commands.h"
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 
 namespace fty::agroup {
 
@@ -15,45 +16,35 @@ unsigned List::run()
         throw rest::Error(ret.error());
     }
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
-    }
-
-    fty::Message msg = message(fty::commands::list::Subject);
+    auto page = Page::parse(m_request, &commands::readMany::isField);
 
-    auto ret = bus.send(fty::Channel, msg);
-    if (!ret) {
-        throw rest::errors::Internal(ret.error());
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
+    fty::MessageBus& bus = **conn;
 
-    auto info = ret->userData.decode<fty::commands::list::Out>();
-    if (!info) {
-        throw rest::errors::Internal(info.error());
+    // Nothing is read if the client has the current data already
+    std::string tag = etag(bus, false);
+    if (notModified(m_request.header("If-None-Match"), m_reply, tag)) {
+        return HTTP_NOT_MODIFIED;
     }
 
-    if (info->size()) {
-        pack::ObjectList<fty::commands::read::Out> out;
-        for(const auto& it: *info) {
-            fty::Message readMsg = message(fty::commands::read::Subject);
-
-            fty::commands::read::In in;
-            in.id = it.id;
-
-            readMsg.userData.setString(*pack::json::serialize(in));
+    // All groups come in one reply, so the page costs one bus round-trip regardless of the number of groups
+    fty::commands::readMany::In in;
+    in.all = true;
+    page.apply(in);
 
-            auto readRet = bus.send(fty::Channel, readMsg);
-            if (!readRet) {
-                throw rest::errors::Internal(readRet.error());
-            }
-
-            auto group = readRet->userData.decode<fty::commands::read::Out>();
-            if (!group) {
-                throw rest::errors::Internal(group.error());
-            }
-            out.append(*group);
+    auto groups = request<commands::ReadMany>(bus, in, fty::Message::Encoding::Binary);
+    if (!groups) {
+        if (isBusy(groups.error())) {
+            return busy(m_reply);
         }
-        m_reply << *pack::json::serialize(out);
+        throw rest::errors::Internal(groups.error());
+    }
+
+    if (groups->size()) {
+        m_reply << *pack::json::serialize(*groups);
     } else {
         m_reply << "[]";
     }
@@ -26,6 +26,7 @@
 #include "common/commands.h"
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 
 namespace fty::agroup {
 
@@ -41,25 +42,26 @@ unsigned Read::run()
         throw rest::errors::RequestParamRequired("id");
     }
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
+    fty::MessageBus& bus = **conn;
 
-    fty::Message msg = message(fty::commands::read::Subject);
+    // Nothing is read if the client has the current data already
+    std::string tag = etag(bus, false);
+    if (notModified(m_request.header("If-None-Match"), m_reply, tag)) {
+        return HTTP_NOT_MODIFIED;
+    }
 
     fty::commands::read::In in;
     in.id = fty::convert<uint16_t>(*strIdPrt);
 
-    msg.userData.setString(*pack::json::serialize(in));
-
-    auto ret = bus.send(fty::Channel, msg);
-    if (!ret) {
-        throw rest::errors::Internal(ret.error());
-    }
-
-    auto info = ret->userData.decode<fty::commands::read::Out>();
+    auto info = request<commands::Read>(bus, in);
     if (!info) {
+        if (isBusy(info.error())) {
+            return busy(m_reply);
+        }
         throw rest::errors::Internal(info.error());
     }
 
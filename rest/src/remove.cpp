@@ -2,6 +2,7 @@
 #include <fty/rest/component.h>
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 #include "common/commands.h"
 
 namespace fty::agroup {
@@ -18,27 +19,23 @@ unsigned Remove::run()
         throw rest::errors::RequestParamRequired("id");
     }
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
-
-    auto msg = message(commands::remove::Subject);
+    fty::MessageBus& bus = **conn;
 
     fty::commands::remove::In in;
     in.append(fty::convert<uint64_t>(*strIdPrt));
 
-    msg.userData.setString(*pack::json::serialize(in));
-
-    auto ret = bus.send(fty::Channel, msg);
-    if (!ret) {
-        throw rest::errors::Internal(ret.error());
-    }
-
-    auto info = ret->userData.decode<fty::commands::remove::Out>();
+    auto info = request<commands::Remove>(bus, in);
     if (!info) {
+        if (isBusy(info.error())) {
+            return busy(m_reply);
+        }
         throw rest::errors::Internal(info.error());
     }
+    versionChanged();
 
     if (info->size()) {
         m_reply << *pack::json::serialize(*info);
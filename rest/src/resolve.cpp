@@ -1,7 +1,9 @@
 #include "resolve.h"
 #include "common/commands.h"
+#include "common/logger.h"
 #include "common/message-bus.h"
 #include "group-rest.h"
+#include "shared-bus.h"
 #include <fty/rest/component.h>
 #include <asset/json.h>
 #include <fty/split.h>
@@ -20,38 +22,95 @@ unsigned Resolve::run()
         throw rest::errors::RequestParamRequired("id");
     }
 
-    fty::MessageBus bus;
-    if (auto res = bus.init(AgentName); !res) {
-        throw rest::errors::Internal(res.error());
+    auto page = Page::parse(m_request, &commands::resolve::isField);
+
+    // Compact view is the default: it's the projection built by the daemon for all assets at once. Full one is the
+    // fty-asset JSON built per asset (N+1 queries) and could not be cut to fields, see README.md
+    auto view    = m_request.queryArg<std::string>("view");
+    bool compact = !view || *view == "compact";
+    if (view && !compact && *view != "full") {
+        throw rest::errors::RequestParamBad("view", *view, "'full' or 'compact'");
+    }
+    if (!compact && !page.fields.empty()) {
+        throw rest::errors::RequestParamBad("fields", fty::implode(page.fields, ","), "fields of compact view");
+    }
+
+    auto conn = SharedBus::get();
+    if (!conn) {
+        throw rest::errors::Internal(conn.error());
     }
+    fty::MessageBus& bus = **conn;
 
-    fty::Message msg = message(fty::commands::resolve::Subject);
+    // Nothing is read if the client has the current data already. Tag of assets is weak, so the client should check it
+    // on every use instead of caching the answer.
+    m_reply.setHeader("Cache-Control", "no-cache");
+    std::string tag = etag(bus, true);
+    if (notModified(m_request.header("If-None-Match"), m_reply, tag)) {
+        return HTTP_NOT_MODIFIED;
+    }
 
     fty::commands::resolve::In in;
-    in.id = fty::convert<uint16_t>(*strIdPrt);
+    in.id      = fty::convert<uint16_t>(*strIdPrt);
+    in.details = compact;
+    page.apply(in);
 
-    msg.userData.setString(*pack::json::serialize(in));
+    // Count of all assets is needed only for a page, it's requested along with the page
+    std::future<Expected<commands::resolveCount::Out>> total;
+    if (page.limit || page.offset) {
+        commands::resolveCount::In count;
+        count.id = in.id;
+        total    = requestAsync<commands::ResolveCount>(bus, count);
+    }
 
-    auto ret = bus.send(fty::Channel, msg);
-    if (!ret) {
-        throw rest::errors::Internal(ret.error());
+    // Resolve result could be large, so it is requested in compact binary encoding. The reply is received before
+    // anything is written, so errors are still answered with their status.
+    auto assets = request<commands::Resolve>(bus, in, fty::Message::Encoding::Binary);
+    if (!assets) {
+        if (isBusy(assets.error())) {
+            return busy(m_reply);
+        }
+        throw rest::errors::Internal(assets.error());
     }
 
-    auto info = ret->userData.decode<fty::commands::resolve::Out>();
-    if (!info) {
-        throw rest::errors::Internal(info.error());
+    if (total.valid()) {
+        if (auto count = total.get()) {
+            m_reply.setHeader("X-Total-Count", std::to_string(count->total.value()));
+        } else {
+            logWarn("Cannot count assets of group {}: {}", in.id.value(), count.error());
+        }
     }
 
-    std::vector<std::string> out;
-    for(const auto& it: *info) {
-        std::string json = asset::getJsonAsset(fty::convert<uint32_t>(it.id.value()));
+    // Every asset is written as soon as it is built, so the answer is never kept whole in memory and the client gets
+    // the first asset without waiting for the last one
+    m_reply.setChunkedEncoding(HTTP_OK);
+    m_reply << "[";
+
+    // Status is sent already, so an asset which could not be built is skipped: it's most likely removed after
+    // resolving. The answer is always closed to stay a valid json list.
+    bool first = true;
+    for (const auto& it : *assets) {
+        std::string json;
+        try {
+            if (!compact) {
+                json = asset::getJsonAsset(fty::convert<uint32_t>(it.id.value()));
+            } else if (auto ret = pack::json::serialize(it)) {
+                json = *ret;
+            }
+        } catch (const std::exception& e) {
+            logWarn("Cannot build information of asset {}: {}", it.id.value(), e.what());
+            continue;
+        }
+
         if (json.empty()) {
-            throw rest::errors::Internal("Cannot build asset information");
+            logWarn("Cannot build information of asset {}", it.id.value());
+            continue;
         }
-        out.push_back(json);
+
+        m_reply << (first ? "" : ", ") << json;
+        first = false;
     }
 
-    m_reply << "[" << fty::implode(out, ", ") << "]";
+    m_reply << "]";
 
     return HTTP_OK;
 }
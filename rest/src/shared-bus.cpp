@@ -0,0 +1,34 @@
+#include "shared-bus.h"
+#include "group-rest.h"
+#include <fmt/format.h>
+#include <unistd.h>
+
+namespace fty::agroup {
+
+SharedBus& SharedBus::instance()
+{
+    static SharedBus inst;
+    return inst;
+}
+
+Expected<std::shared_ptr<MessageBus>> SharedBus::get()
+{
+    auto& inst = instance();
+    auto& slot = inst.m_slots[inst.m_next++ % PoolSize];
+
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.bus && slot.bus->connected()) {
+        return slot.bus;
+    }
+
+    // Replies are routed by client name, so every connection gets its own one
+    auto bus = std::make_shared<MessageBus>();
+    if (auto res = bus->init(fmt::format("{}.{}.{}", AgentName, getpid(), ++inst.m_connections)); !res) {
+        return unexpected(res.error());
+    }
+
+    slot.bus = bus;
+    return bus;
+}
+
+} // namespace fty::agroup
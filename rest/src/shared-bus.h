@@ -0,0 +1,39 @@
+#pragma once
+#include "common/message-bus.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace fty::agroup {
+
+/// Message bus connections shared by the REST handlers of all tntnet worker threads.
+/// A connection is made on its first use and made again after it was broken (a write failed or several requests in a
+/// row timed out, see MessageBus::connected), so an HTTP request does not pay for the malamute handshake.
+/// One connection serves any number of concurrent requests, the pool only spreads them over several I/O threads.
+class SharedBus
+{
+public:
+    static constexpr size_t PoolSize = 4;
+
+    /// Returns a connected bus. Handler keeps it for the whole request, so a connection which is replaced
+    /// meanwhile stays alive until its requests are done.
+    static Expected<std::shared_ptr<MessageBus>> get();
+
+private:
+    struct Slot
+    {
+        std::mutex                  mutex;
+        std::shared_ptr<MessageBus> bus;
+    };
+
+    SharedBus() = default;
+    static SharedBus& instance();
+
+private:
+    std::array<Slot, PoolSize> m_slots;
+    std::atomic<size_t>        m_next        = 0;
+    std::atomic<uint64_t>      m_connections = 0;
+};
+
+} // namespace fty::agroup
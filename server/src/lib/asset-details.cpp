@@ -0,0 +1,201 @@
+#include "asset-details.h"
+#include "metrics.h"
+#include <asset/db.h>
+#include <fty/string-utils.h>
+#include <set>
+#include <unordered_map>
+
+namespace fty {
+
+// =====================================================================================================================
+
+/// Maximum number of ids in one `IN (...)` list
+static constexpr size_t ChunkSize = 1000;
+
+/// Depth of the location tree stored in v_bios_asset_element_super_parent
+static constexpr int MaxParents = 10;
+
+static constexpr const char* Elements = R"(
+    SELECT
+        e.id_asset_element AS id,
+        t.name AS type,
+        COALESCE(d.name, '') AS subtype,
+        e.status,
+        e.priority
+    FROM
+        t_bios_asset_element AS e
+    JOIN t_bios_asset_element_type AS t
+        ON t.id_asset_element_type = e.id_type
+    LEFT JOIN t_bios_asset_device_type AS d
+        ON d.id_asset_device_type = e.id_subtype
+    WHERE e.id_asset_element IN ({}))";
+
+static constexpr const char* Attributes = R"(
+    SELECT
+        id_asset_element AS id,
+        keytag,
+        value
+    FROM
+        t_bios_asset_ext_attributes
+    WHERE id_asset_element IN ({}))";
+
+static constexpr const char* Parents = R"(
+    SELECT
+        id_asset_element AS id,
+        COALESCE(id_parent1, 0) AS p1,
+        COALESCE(id_parent2, 0) AS p2,
+        COALESCE(id_parent3, 0) AS p3,
+        COALESCE(id_parent4, 0) AS p4,
+        COALESCE(id_parent5, 0) AS p5,
+        COALESCE(id_parent6, 0) AS p6,
+        COALESCE(id_parent7, 0) AS p7,
+        COALESCE(id_parent8, 0) AS p8,
+        COALESCE(id_parent9, 0) AS p9,
+        COALESCE(id_parent10, 0) AS p10
+    FROM
+        v_bios_asset_element_super_parent
+    WHERE id_asset_element IN ({}))";
+
+static constexpr const char* PowerSources = R"(
+    SELECT DISTINCT
+        id_asset_device_dest AS id,
+        id_asset_device_src AS source
+    FROM
+        t_bios_asset_link
+    WHERE id_asset_device_dest IN ({}))";
+
+static constexpr const char* References = R"(
+    SELECT
+        e.id_asset_element AS id,
+        e.name,
+        t.name AS type
+    FROM
+        t_bios_asset_element AS e
+    JOIN t_bios_asset_element_type AS t
+        ON t.id_asset_element_type = e.id_type
+    WHERE e.id_asset_element IN ({}))";
+
+/// Splits ids into comma separated lists of at most `ChunkSize` ids
+template <typename Ids>
+static std::vector<std::string> chunks(const Ids& ids)
+{
+    std::vector<std::string> ret;
+    std::vector<uint64_t>    chunk;
+    for (const auto& id : ids) {
+        chunk.push_back(id);
+        if (chunk.size() == ChunkSize) {
+            ret.push_back(fty::implode(chunk, ","));
+            chunk.clear();
+        }
+    }
+    if (!chunk.empty()) {
+        ret.push_back(fty::implode(chunk, ","));
+    }
+    return ret;
+}
+
+// =====================================================================================================================
+
+void assetDetails(tnt::Connection& conn, commands::resolve::Out& assets, const pack::StringList& fields)
+{
+    Metrics::Timer timer(Metrics::instance().dbQuery);
+
+    using Answer = commands::resolve::Answer;
+
+    std::vector<uint64_t>                 ids;
+    std::unordered_map<uint64_t, Answer*> index;
+    for (auto& asset : assets) {
+        ids.push_back(asset.id.value());
+        index.emplace(asset.id.value(), &asset);
+    }
+
+    auto find = [&](uint64_t id) -> Answer* {
+        auto it = index.find(id);
+        return it != index.end() ? it->second : nullptr;
+    };
+
+    auto wanted = [&](std::string_view field) {
+        return fields.empty() || commands::contains(fields, field);
+    };
+
+    bool element = wanted("type") || wanted("sub_type") || wanted("status") || wanted("priority");
+
+    // Locations and power sources are collected as ids first, their names are selected at once for all assets
+    std::unordered_map<uint64_t, std::vector<uint64_t>> locations;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> powers;
+    std::set<uint64_t>                                  referenced;
+
+    for (const auto& list : chunks(ids)) {
+        if (element) {
+            for (const auto& row : conn.select(fmt::format(Elements, list))) {
+                if (auto asset = find(row.get<uint64_t>("id"))) {
+                    if (wanted("type")) {
+                        asset->type = row.get("type");
+                    }
+                    if (wanted("sub_type")) {
+                        asset->subType = row.get("subtype");
+                    }
+                    if (wanted("status")) {
+                        asset->status = row.get("status");
+                    }
+                    if (wanted("priority")) {
+                        asset->priority = row.get<uint32_t>("priority");
+                    }
+                }
+            }
+        }
+
+        if (wanted("ext")) {
+            for (const auto& row : conn.select(fmt::format(Attributes, list))) {
+                if (auto asset = find(row.get<uint64_t>("id"))) {
+                    asset->ext.append(row.get("keytag"), row.get("value"));
+                }
+            }
+        }
+
+        if (wanted("locations")) {
+            for (const auto& row : conn.select(fmt::format(Parents, list))) {
+                auto& parents = locations[row.get<uint64_t>("id")];
+                for (int i = 1; i <= MaxParents; ++i) {
+                    if (auto parent = row.get<uint64_t>(fmt::format("p{}", i))) {
+                        parents.push_back(parent);
+                        referenced.insert(parent);
+                    }
+                }
+            }
+        }
+
+        if (wanted("powers")) {
+            for (const auto& row : conn.select(fmt::format(PowerSources, list))) {
+                auto source = row.get<uint64_t>("source");
+                powers[row.get<uint64_t>("id")].push_back(source);
+                referenced.insert(source);
+            }
+        }
+    }
+
+    std::unordered_map<uint64_t, commands::resolve::Reference> references;
+    for (const auto& list : chunks(referenced)) {
+        for (const auto& row : conn.select(fmt::format(References, list))) {
+            auto& ref = references[row.get<uint64_t>("id")];
+            ref.id    = row.get<uint64_t>("id");
+            ref.name  = row.get("name");
+            ref.type  = row.get("type");
+        }
+    }
+
+    auto fill = [&](const std::vector<uint64_t>& refIds, pack::ObjectList<commands::resolve::Reference>& out) {
+        for (const auto& id : refIds) {
+            if (auto it = references.find(id); it != references.end()) {
+                out.append(it->second);
+            }
+        }
+    };
+
+    for (auto& asset : assets) {
+        fill(locations[asset.id.value()], asset.locations);
+        fill(powers[asset.id.value()], asset.powers);
+    }
+}
+
+} // namespace fty
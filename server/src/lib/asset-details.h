@@ -0,0 +1,16 @@
+#pragma once
+#include "common/commands.h"
+
+namespace tnt {
+class Connection;
+}
+
+namespace fty {
+
+/// Fills details of resolved assets: type, status, priority, locations, power sources and ext attributes.
+/// Only listed `fields` are filled, all of them if the list is empty.
+/// Every kind of details is selected for a chunk of assets by one query, so the number of queries grows with the
+/// number of chunks, not with the number of assets.
+void assetDetails(tnt::Connection& conn, commands::resolve::Out& assets, const pack::StringList& fields = {});
+
+} // namespace fty
@@ -0,0 +1,282 @@
+#include "asset-index.h"
+#include "ip-trie.h"
+#include "string-column.h"
+#include <asset/db.h>
+#include <algorithm>
+#include <atomic>
+#include <fty/string-utils.h>
+#include <fty_common_asset_types.h>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace fty {
+
+// =====================================================================================================================
+
+static constexpr const char* Attributes = R"(
+    SELECT
+        id_asset_element AS id,
+        keytag,
+        value
+    FROM
+        t_bios_asset_ext_attributes
+    WHERE
+        keytag IN ('name', 'hostname.1', 'device.contact', 'contact_email'))";
+
+static constexpr const char* IpAttributes = R"(
+    SELECT
+        a.id_asset_element AS id,
+        a.value
+    FROM
+        t_bios_asset_ext_attributes AS a
+    JOIN t_bios_asset_element AS e
+        ON e.id_asset_element = a.id_asset_element
+    WHERE
+        e.id_type = :type AND a.keytag LIKE 'ip.%')";
+
+static void connect()
+{
+    // Normal connect in _this_ thread, otherwise tntdb will fail
+    tntdb::connect(getenv("DBURL") ? getenv("DBURL") : DBConn::url);
+}
+
+/// IPv4 addresses of devices
+using Addresses = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+
+static void addAddress(Addresses& addresses, uint64_t id, const std::string& value)
+{
+    if (auto addr = IpTrie::address(value)) {
+        addresses[id].push_back(*addr);
+    }
+}
+
+// =====================================================================================================================
+
+class AssetIndex::Impl
+{
+public:
+    struct Columns
+    {
+        StringColumn name;
+        StringColumn hostName;
+        StringColumn contact;
+
+        void add(uint64_t id, const std::string& key, const std::string& value)
+        {
+            if (key == "name") {
+                name.add(id, value);
+            } else if (key == "hostname.1") {
+                hostName.add(id, value);
+            } else {
+                contact.add(id, value);
+            }
+        }
+
+        void remove(uint64_t id)
+        {
+            name.remove(id);
+            hostName.remove(id);
+            contact.remove(id);
+        }
+
+        const StringColumn* column(Group::Fields field) const
+        {
+            switch (field) {
+                case Group::Fields::Name:
+                    return &name;
+                case Group::Fields::HostName:
+                    return &hostName;
+                case Group::Fields::Contact:
+                    return &contact;
+                default:
+                    return nullptr;
+            }
+        }
+    };
+
+public:
+    // Updates are serialized by `updateMutex` from reading of the database to applying, so an update which read the
+    // database later is always applied later. Readers only take shared `mutex`.
+    std::mutex                                updateMutex;
+    std::shared_mutex                         mutex;
+    std::atomic<bool>                         ready   = false;
+    std::atomic<uint64_t>                     version = 0;
+    Columns                                   columns;
+    Addresses                                 addresses;
+    std::unordered_map<std::string, uint64_t> ids;
+};
+
+// =====================================================================================================================
+
+AssetIndex& AssetIndex::instance()
+{
+    static AssetIndex inst;
+    return inst;
+}
+
+AssetIndex::AssetIndex()
+    : m_impl(new Impl)
+{
+}
+
+AssetIndex::~AssetIndex()
+{
+}
+
+bool AssetIndex::ready()
+{
+    return instance().m_impl->ready;
+}
+
+Expected<void> AssetIndex::reload()
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.updateMutex);
+
+    Impl::Columns                             columns;
+    Addresses                                 addresses;
+    std::unordered_map<std::string, uint64_t> ids;
+
+    try {
+        connect();
+        tnt::Connection conn;
+
+        for (const auto& row : conn.select("SELECT id_asset_element AS id, name FROM t_bios_asset_element")) {
+            ids.emplace(row.get("name"), row.get<uint64_t>("id"));
+        }
+
+        for (const auto& row : conn.select(Attributes)) {
+            columns.add(row.get<uint64_t>("id"), row.get("keytag"), row.get("value"));
+        }
+
+        for (const auto& row : conn.select(IpAttributes, "type"_p = persist::DEVICE)) {
+            addAddress(addresses, row.get<uint64_t>("id"), row.get("value"));
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+
+    std::unique_lock<std::shared_mutex> lock(impl.mutex);
+    impl.columns   = std::move(columns);
+    impl.addresses = std::move(addresses);
+    impl.ids       = std::move(ids);
+    impl.ready     = true;
+    ++impl.version;
+    return {};
+}
+
+Expected<void> AssetIndex::assetChanged(const std::string& assetName)
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.updateMutex);
+
+    try {
+        connect();
+        tnt::Connection conn;
+
+        std::vector<uint64_t> found;
+        for (const auto& row : conn.select(
+                 "SELECT id_asset_element AS id FROM t_bios_asset_element WHERE name = :name", "name"_p = assetName)) {
+            found.push_back(row.get<uint64_t>("id"));
+        }
+
+        if (found.empty()) {
+            std::unique_lock<std::shared_mutex> lock(impl.mutex);
+            if (auto it = impl.ids.find(assetName); it != impl.ids.end()) {
+                impl.columns.remove(it->second);
+                impl.addresses.erase(it->second);
+                impl.ids.erase(it);
+            }
+            ++impl.version;
+            return {};
+        }
+
+        uint64_t                                         id = found.front();
+        std::vector<std::pair<std::string, std::string>> attributes;
+        for (const auto& row : conn.select(std::string(Attributes) + " AND id_asset_element = :id", "id"_p = id)) {
+            attributes.emplace_back(row.get("keytag"), row.get("value"));
+        }
+
+        Addresses addresses;
+        for (const auto& row : conn.select(std::string(IpAttributes) + " AND a.id_asset_element = :id",
+                 "type"_p = persist::DEVICE, "id"_p = id)) {
+            addAddress(addresses, id, row.get("value"));
+        }
+
+        std::unique_lock<std::shared_mutex> lock(impl.mutex);
+        impl.columns.remove(id);
+        for (const auto& [key, value] : attributes) {
+            impl.columns.add(id, key, value);
+        }
+        impl.addresses.erase(id);
+        impl.addresses.merge(addresses);
+        impl.ids[assetName] = id;
+        ++impl.version;
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+    return {};
+}
+
+uint64_t AssetIndex::version()
+{
+    return instance().m_impl->version;
+}
+
+Expected<std::vector<uint64_t>> AssetIndex::contains(Group::Fields field, const std::string& value)
+{
+    auto& impl = *instance().m_impl;
+    if (!impl.ready) {
+        return unexpected("Index is not loaded");
+    }
+
+    // Sql wildcards and non ascii case folding are left to database
+    std::string needle;
+    for (char ch : value) {
+        if (ch == '%' || ch == '_' || ch == '\\' || static_cast<unsigned char>(ch) > 127) {
+            return unexpected("Value '{}' is not supported by index", value);
+        }
+        needle.push_back((ch >= 'A' && ch <= 'Z') ? char(ch - 'A' + 'a') : ch);
+    }
+
+    std::shared_lock<std::shared_mutex> lock(impl.mutex);
+    if (auto column = impl.columns.column(field)) {
+        return column->contains(needle);
+    }
+    return unexpected("Field is not indexed");
+}
+
+Expected<std::vector<uint64_t>> AssetIndex::ipAddress(const std::string& value)
+{
+    auto& impl = *instance().m_impl;
+    if (!impl.ready) {
+        return unexpected("Index is not loaded");
+    }
+
+    IpTrie trie;
+    for (const auto& addr : fty::split(value, "|")) {
+        auto networks = IpTrie::parse(addr);
+        if (!networks) {
+            return unexpected("Value '{}' is not supported by index", addr);
+        }
+        for (const auto& network : *networks) {
+            trie.insert(network);
+        }
+    }
+
+    std::vector<uint64_t>               ret;
+    std::shared_lock<std::shared_mutex> lock(impl.mutex);
+    for (const auto& [id, addresses] : impl.addresses) {
+        for (uint32_t addr : addresses) {
+            if (trie.match(addr)) {
+                ret.push_back(id);
+                break;
+            }
+        }
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+} // namespace fty
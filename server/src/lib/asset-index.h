@@ -0,0 +1,41 @@
+#pragma once
+#include "common/group.h"
+#include <fty/expected.h>
+
+namespace fty {
+
+/// In-memory index of asset attributes used by `Contains` conditions (names, host names and contacts) and by ip address
+/// conditions (IPv4 addresses of devices).
+/// Loaded on start and refreshed on asset events.
+class AssetIndex
+{
+public:
+    static AssetIndex& instance();
+
+public:
+    AssetIndex();
+    ~AssetIndex();
+
+    static bool ready();
+
+    /// Loads attributes of all assets
+    static Expected<void> reload();
+    /// Reloads attributes of the asset
+    static Expected<void> assetChanged(const std::string& assetName);
+
+    /// Returns sorted ids of the assets which attribute for the field contains the value (case insensitive)
+    static Expected<std::vector<uint64_t>> contains(Group::Fields field, const std::string& value);
+
+    /// Returns sorted ids of the devices which have an address matched by `|` separated IPv4 patterns,
+    /// see IpTrie::parse
+    static Expected<std::vector<uint64_t>> ipAddress(const std::string& value);
+
+    /// Grows after every applied reload and asset update
+    static uint64_t version();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace fty
@@ -1,4 +1,6 @@
 #pragma once
+#include "event-batcher.h"
+#include "lane.h"
 #include <fty/expected.h>
 #include <pack/pack.h>
 
@@ -7,12 +9,54 @@ namespace fty {
 class Config : public pack::Node
 {
 public:
-    pack::String dbpath    = FIELD("dbpath");
-    pack::String logger    = FIELD("logger");
-    pack::String actorName = FIELD("actor-name", "automatic-group");
+    /// Worker lane which serves requests of listed subjects, see Lane
+    struct Lane : public pack::Node
+    {
+        pack::String                  name      = FIELD("name");
+        pack::UInt32                  workers   = FIELD("workers", 2);
+        pack::UInt32                  queueSize = FIELD("queue-size", 1000);
+        pack::Enum<fty::Lane::Policy> policy    = FIELD("policy");
+        pack::UInt32                  maxWait   = FIELD("max-wait", 10000); // ms, 0 to wait forever
+        pack::StringList              subjects  = FIELD("subjects");
+
+        using pack::Node::Node;
+        META(Lane, name, workers, queueSize, policy, maxWait, subjects);
+    };
+
+    /// Executor of background jobs (asset events, membership refresh), see Executor. Lane workers are pinned to the
+    /// same cpus.
+    struct Pool : public pack::Node
+    {
+        pack::UInt32     workers = FIELD("workers", 0); // 0 is number of cores
+        pack::UInt32List cpus    = FIELD("cpus");       // cpus to pin pool and lane workers to, empty to not pin
+
+        using pack::Node::Node;
+        META(Pool, workers, cpus);
+    };
+
+    /// Publication of group change notifications, see EventBatcher
+    struct Events : public pack::Node
+    {
+        pack::Enum<EventBatcher::Mode> mode   = FIELD("mode"); // per-event unless batch is set
+        pack::UInt32                   window = FIELD("window", 100); // ms
+
+        using pack::Node::Node;
+        META(Events, mode, window);
+    };
+
+public:
+    pack::String           dbpath          = FIELD("dbpath");
+    pack::String           logger          = FIELD("logger");
+    pack::String           actorName       = FIELD("actor-name", "automatic-group");
+    pack::Bool             membershipTable = FIELD("membership-table", false);
+    pack::ObjectList<Lane> lanes           = FIELD("lanes");
+    Pool                   pool            = FIELD("pool");
+    Events                 events          = FIELD("events");
+    pack::String           metricsFile     = FIELD("metrics-file"); // Prometheus text file, empty to disable
+    pack::UInt32           metricsInterval = FIELD("metrics-interval", 15); // seconds
 
     using pack::Node::Node;
-    META(Config, dbpath, logger, actorName);
+    META(Config, dbpath, logger, actorName, membershipTable, lanes, pool, events, metricsFile, metricsInterval);
 
 public:
     static Config& instance();
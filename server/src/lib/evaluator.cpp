@@ -0,0 +1,250 @@
+#include "evaluator.h"
+#include <algorithm>
+#include <fty/string-utils.h>
+
+namespace fty {
+
+// =====================================================================================================================
+
+static char lower(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? char(ch - 'A' + 'a') : ch;
+}
+
+static std::string toLower(const std::string& str)
+{
+    std::string ret(str);
+    for (auto& ch : ret) {
+        ch = lower(ch);
+    }
+    return ret;
+}
+
+/// Compares value with lower-cased pattern
+static bool equals(std::string_view value, std::string_view pattern)
+{
+    if (value.size() != pattern.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (lower(value[i]) != pattern[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool startsWith(std::string_view value, std::string_view pattern)
+{
+    return value.size() >= pattern.size() && equals(value.substr(0, pattern.size()), pattern);
+}
+
+static bool contains(std::string_view value, std::string_view pattern)
+{
+    if (pattern.empty()) {
+        return true;
+    }
+    for (size_t i = 0; i + pattern.size() <= value.size(); ++i) {
+        if (lower(value[i]) == pattern[0] && equals(value.substr(i, pattern.size()), pattern)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// =====================================================================================================================
+
+Expected<Evaluator> Evaluator::compile(const Group::Rules& rules)
+{
+    Evaluator eval;
+    if (auto ret = eval.build(rules); !ret) {
+        return unexpected(ret.error());
+    } else if (*ret > MaxStack) {
+        return unexpected("Rules are too complex");
+    }
+    return std::move(eval);
+}
+
+Expected<size_t> Evaluator::build(const Group::Rules& rules)
+{
+    if (rules.conditions.empty()) {
+        return unexpected("Request is empty");
+    }
+
+    // Stack required by postfix evaluation: i operands are on stack while i-th operand is evaluated
+    size_t stack = 0;
+    size_t index = 0;
+    for (const auto& it : rules.conditions) {
+        if (it.is<Group::Condition>()) {
+            const auto& cond = it.get<Group::Condition>();
+
+            Op op;
+            op.code  = OpCode::Condition;
+            op.field = cond.field;
+            op.op    = cond.op;
+            op.first = uint32_t(m_patterns.size());
+            op.trie  = NoTrie;
+
+            switch (op.field) {
+                case Group::Fields::IPAddress:
+                    for (const auto& addr : fty::split(cond.value, "|")) {
+                        if (op.op != Group::ConditionOp::Contains) {
+                            if (auto networks = IpTrie::parse(addr)) {
+                                if (op.trie == NoTrie) {
+                                    op.trie = uint32_t(m_tries.size());
+                                    m_tries.emplace_back();
+                                }
+                                for (const auto& network : *networks) {
+                                    m_tries[op.trie].insert(network);
+                                }
+                                continue;
+                            }
+                        }
+
+                        Pattern pattern;
+                        if (size_t pos = addr.find("*"); pos != std::string::npos) {
+                            pattern.value  = toLower(addr.substr(0, pos));
+                            pattern.prefix = true;
+                        } else {
+                            pattern.value = toLower(addr);
+                        }
+                        m_patterns.push_back(pattern);
+                    }
+                    break;
+                case Group::Fields::Contact:
+                case Group::Fields::HostName:
+                case Group::Fields::Location:
+                case Group::Fields::Name:
+                case Group::Fields::Type: {
+                    Pattern pattern;
+                    pattern.value = toLower(cond.value);
+                    m_patterns.push_back(pattern);
+                    break;
+                }
+                case Group::Fields::Unknown:
+                default:
+                    return unexpected("Unsupported field '{}' in condition", cond.field.value());
+            }
+
+            op.count = uint32_t(m_patterns.size()) - op.first;
+            m_program.push_back(op);
+            stack = std::max(stack, index + 1);
+        } else {
+            auto ret = build(it.get<Group::Rules>());
+            if (!ret) {
+                return unexpected(ret.error());
+            }
+            stack = std::max(stack, index + *ret);
+        }
+        ++index;
+    }
+
+    Op op;
+    op.code  = rules.groupOp == Group::LogicalOp::And ? OpCode::And : OpCode::Or;
+    op.first = 0;
+    op.count = uint32_t(index);
+    op.trie  = NoTrie;
+    m_program.push_back(op);
+
+    return stack;
+}
+
+bool Evaluator::match(const AssetRecord& asset) const
+{
+    bool   stack[MaxStack];
+    size_t top = 0;
+
+    for (const auto& op : m_program) {
+        switch (op.code) {
+            case OpCode::Condition:
+                stack[top++] = match(op, asset);
+                break;
+            case OpCode::And:
+            case OpCode::Or: {
+                bool isAnd = op.code == OpCode::And;
+                bool res   = isAnd;
+                for (size_t i = top - op.count; i < top; ++i) {
+                    res = isAnd ? res && stack[i] : res || stack[i];
+                }
+                top -= op.count;
+                stack[top++] = res;
+                break;
+            }
+        }
+    }
+
+    return top == 1 && stack[0];
+}
+
+bool Evaluator::matchValue(const Op& op, std::string_view value) const
+{
+    for (uint32_t i = op.first; i < op.first + op.count; ++i) {
+        const auto& pattern = m_patterns[i];
+        if (pattern.prefix) {
+            if (startsWith(value, pattern.value)) {
+                return true;
+            }
+        } else if (op.op == Group::ConditionOp::Contains) {
+            if (contains(value, pattern.value)) {
+                return true;
+            }
+        } else if (equals(value, pattern.value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Evaluator::matchIp(const Op& op, std::string_view value) const
+{
+    if (op.trie != NoTrie && m_tries[op.trie].match(value)) {
+        return true;
+    }
+    return matchValue(op, value);
+}
+
+bool Evaluator::match(const Op& op, const AssetRecord& asset) const
+{
+    auto any = [&](const std::vector<std::string>& values, auto matcher) {
+        for (const auto& value : values) {
+            if ((this->*matcher)(op, value)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    bool isNot = op.op == Group::ConditionOp::IsNot;
+
+    switch (op.field) {
+        case Group::Fields::Name:
+            return !asset.name.empty() && matchValue(op, asset.name) != isNot;
+        case Group::Fields::Type:
+            return !asset.type.empty() && matchValue(op, asset.type) != isNot;
+        case Group::Fields::Contact:
+            return any(asset.contacts, &Evaluator::matchValue) != isNot;
+        case Group::Fields::Location:
+            // Location is matched if any of containing datacenters satisfies the condition
+            for (const auto& location : asset.locations) {
+                if (matchValue(op, location) != isNot) {
+                    return true;
+                }
+            }
+            return false;
+        case Group::Fields::HostName:
+            if (!asset.device) {
+                return false;
+            }
+            if (isNot) {
+                return asset.hostName.empty() || !matchValue(op, asset.hostName);
+            }
+            return !asset.hostName.empty() && matchValue(op, asset.hostName);
+        case Group::Fields::IPAddress:
+            return asset.device && any(asset.ips, &Evaluator::matchIp) != isNot;
+        case Group::Fields::Unknown:
+        default:
+            return false;
+    }
+}
+
+} // namespace fty
@@ -0,0 +1,73 @@
+#pragma once
+#include "common/group.h"
+#include "ip-trie.h"
+#include <fty/expected.h>
+#include <string_view>
+#include <vector>
+
+namespace fty {
+
+/// Asset attributes which are used by group rules
+struct AssetRecord
+{
+    uint64_t                 id     = 0;
+    bool                     device = false;
+    std::string              name;
+    std::string              type;
+    std::string              hostName;
+    std::vector<std::string> contacts;
+    std::vector<std::string> ips;
+    std::vector<std::string> locations;
+};
+
+/// Group rules compiled into flat postfix program, matches single asset without allocations.
+/// Follows semantic of sql resolving: case insensitive comparison, host name and ip address conditions are applicable
+/// to devices only. IPv4 addresses, networks and ranges of ip address condition are matched by one radix trie.
+class Evaluator
+{
+public:
+    static constexpr size_t   MaxStack = 256;
+    static constexpr uint32_t NoTrie   = uint32_t(-1);
+
+public:
+    static Expected<Evaluator> compile(const Group::Rules& rules);
+
+    bool match(const AssetRecord& asset) const;
+
+private:
+    enum class OpCode : uint8_t
+    {
+        Condition,
+        And,
+        Or
+    };
+
+    struct Op
+    {
+        OpCode             code;
+        Group::Fields      field;
+        Group::ConditionOp op;
+        uint32_t           first; // first pattern of condition
+        uint32_t           count; // pattern count of condition, operand count of logical operation
+        uint32_t           trie;  // ip networks of condition, NoTrie if none
+    };
+
+    struct Pattern
+    {
+        std::string value;
+        bool        prefix = false;
+    };
+
+private:
+    Expected<size_t> build(const Group::Rules& rules);
+    bool             match(const Op& op, const AssetRecord& asset) const;
+    bool             matchValue(const Op& op, std::string_view value) const;
+    bool             matchIp(const Op& op, std::string_view value) const;
+
+private:
+    std::vector<Op>      m_program;
+    std::vector<Pattern> m_patterns;
+    std::vector<IpTrie>  m_tries;
+};
+
+} // namespace fty
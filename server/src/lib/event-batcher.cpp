@@ -0,0 +1,179 @@
+#include "event-batcher.h"
+#include "common/logger.h"
+
+namespace fty {
+
+// =====================================================================================================================
+
+void EventBatch::add(const std::string& event, uint64_t id)
+{
+    if (event == commands::notify::Created) {
+        m_created.insert(id);
+    } else if (event == commands::notify::Updated) {
+        if (!m_created.count(id)) {
+            m_updated.insert(id);
+        }
+    } else if (event == commands::notify::Deleted) {
+        m_updated.erase(id);
+        // Subscribers did not hear about this group yet
+        if (!m_created.erase(id)) {
+            m_deleted.insert(id);
+        }
+    }
+}
+
+bool EventBatch::empty() const
+{
+    return m_created.empty() && m_updated.empty() && m_deleted.empty();
+}
+
+commands::notify::BatchPayload EventBatch::payload() const
+{
+    commands::notify::BatchPayload ret;
+    for (auto id : m_created) {
+        ret.created.append(id);
+    }
+    for (auto id : m_updated) {
+        ret.updated.append(id);
+    }
+    for (auto id : m_deleted) {
+        ret.deleted.append(id);
+    }
+    return ret;
+}
+
+// =====================================================================================================================
+
+EventBatcher& EventBatcher::instance()
+{
+    static EventBatcher inst;
+    return inst;
+}
+
+EventBatcher::~EventBatcher()
+{
+    stop();
+}
+
+void EventBatcher::start(MessageBus& bus, Mode mode, std::chrono::milliseconds window)
+{
+    stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bus    = &bus;
+    m_mode   = mode;
+    m_window = window;
+    m_stop   = false;
+    if (m_mode == Mode::Batch) {
+        m_thread = std::thread(&EventBatcher::run, this);
+    }
+}
+
+void EventBatcher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bus = nullptr;
+}
+
+void EventBatcher::notify(const std::string& event, uint64_t id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_bus) {
+        logWarn("Event {} of group {} is not published: publisher is not started", event, id);
+        return;
+    }
+
+    if (m_mode == Mode::PerEvent) {
+        lock.unlock();
+        pack::UInt64 payload;
+        payload = id;
+        publish(event, *pack::json::serialize(payload));
+        return;
+    }
+
+    if (m_batch.empty()) {
+        m_first = std::chrono::steady_clock::now();
+        m_cv.notify_all();
+    }
+    m_batch.add(event, id);
+}
+
+void EventBatcher::publish(const std::string& subject, const std::string& payload)
+{
+    Message msg;
+    msg.meta.subject = subject;
+    msg.meta.status  = Message::Status::Ok;
+    msg.userData.setString(payload);
+
+    if (auto ret = m_bus->publish(fty::Events, msg); !ret) {
+        logError(ret.error());
+    }
+}
+
+void EventBatcher::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [&]() {
+            return m_stop || !m_batch.empty();
+        });
+
+        // Window starts with the first notification of the batch
+        if (!m_batch.empty()) {
+            m_cv.wait_until(lock, m_first + m_window, [&]() {
+                return m_stop;
+            });
+        }
+
+        if (!m_batch.empty()) {
+            EventBatch batch = std::move(m_batch);
+            m_batch          = {};
+            lock.unlock();
+            publish(commands::notify::Batch, *pack::json::serialize(batch.payload()));
+            lock.lock();
+        }
+
+        if (m_stop) {
+            return;
+        }
+    }
+}
+
+// =====================================================================================================================
+
+std::ostream& operator<<(std::ostream& ss, EventBatcher::Mode value)
+{
+    ss << [&]() {
+        switch (value) {
+            case EventBatcher::Mode::PerEvent:
+                return "per-event";
+            case EventBatcher::Mode::Batch:
+                return "batch";
+        }
+        return "unknown";
+    }();
+    return ss;
+}
+
+std::istream& operator>>(std::istream& ss, EventBatcher::Mode& value)
+{
+    std::string strval;
+    ss >> strval;
+    if (strval == "per-event") {
+        value = EventBatcher::Mode::PerEvent;
+    } else if (strval == "batch") {
+        value = EventBatcher::Mode::Batch;
+    }
+    return ss;
+}
+
+} // namespace fty
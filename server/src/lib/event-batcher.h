@@ -0,0 +1,75 @@
+#pragma once
+#include "common/commands.h"
+#include "common/message-bus.h"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace fty {
+
+/// Changes of groups accumulated within one window.
+/// Later event of a group supersedes earlier one: created and then updated group is reported as created, group which
+/// was created and deleted within the window is not reported at all.
+class EventBatch
+{
+public:
+    void add(const std::string& event, uint64_t id);
+    bool empty() const;
+
+    commands::notify::BatchPayload payload() const;
+
+private:
+    std::set<uint64_t> m_created;
+    std::set<uint64_t> m_updated;
+    std::set<uint64_t> m_deleted;
+};
+
+/// Publisher of group change notifications on `FTY.Q.GROUP.EVENT`.
+/// Per-event mode (default) publishes every notification as a separate CREATED/UPDATED/DELETED message as before.
+/// In batch mode, notifications are coalesced within a window into one BATCH message, so bulk operations do not flood
+/// subscribers. Batch mode changes the wire format, so it is opt-in for consumers which understand BATCH.
+class EventBatcher
+{
+public:
+    enum class Mode
+    {
+        PerEvent,
+        Batch
+    };
+
+public:
+    static EventBatcher& instance();
+
+    /// Starts publishing into the bus
+    void start(MessageBus& bus, Mode mode, std::chrono::milliseconds window);
+    /// Publishes pending notifications and stops
+    void stop();
+
+    void notify(const std::string& event, uint64_t id);
+
+private:
+    EventBatcher() = default;
+    ~EventBatcher();
+
+    void run();
+    void publish(const std::string& subject, const std::string& payload);
+
+private:
+    MessageBus*                           m_bus    = nullptr;
+    Mode                                  m_mode   = Mode::PerEvent;
+    std::chrono::milliseconds             m_window = std::chrono::milliseconds(0);
+    std::mutex                            m_mutex;
+    std::condition_variable               m_cv;
+    EventBatch                            m_batch;
+    std::chrono::steady_clock::time_point m_first;
+    bool                                  m_stop = false;
+    std::thread                           m_thread;
+};
+
+std::ostream& operator<<(std::ostream& ss, EventBatcher::Mode value);
+std::istream& operator>>(std::istream& ss, EventBatcher::Mode& value);
+
+} // namespace fty
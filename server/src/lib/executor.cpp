@@ -0,0 +1,181 @@
+#include "executor.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <pthread.h>
+
+namespace fty {
+
+// Worker of which executor is the current thread
+static thread_local const Executor* t_executor = nullptr;
+static thread_local size_t          t_worker   = 0;
+
+// =====================================================================================================================
+
+Executor::Executor(size_t workers, const std::vector<uint32_t>& cpus)
+    : m_cpus(cpus)
+{
+    if (!workers) {
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (size_t i = 0; i < workers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Threads are started when all the deques exist, as they steal from each other
+    for (size_t i = 0; i < workers; ++i) {
+        m_workers[i]->thread = std::thread(&Executor::work, this, i);
+    }
+}
+
+Executor::~Executor()
+{
+    stop();
+}
+
+void Executor::push(Job&& job)
+{
+    if (m_stop) {
+        logDebug("Executor: job is pushed after stop and is dropped");
+        return;
+    }
+
+    // Counted before it is queued, so the counter never goes below zero when the job is taken immediately
+    m_pending.fetch_add(1);
+
+    size_t index = t_executor == this ? t_worker : m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->jobs.push_back(std::move(job));
+    }
+
+    // Sleeping worker registers itself before it checks pending jobs, so one of both sides always sees the other one.
+    // Sleep mutex is taken only if there is someone to wake up.
+    if (m_sleeping.load()) {
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+}
+
+size_t Executor::workers() const
+{
+    return m_workers.size();
+}
+
+size_t Executor::depth() const
+{
+    return m_pending;
+}
+
+uint64_t Executor::stolen() const
+{
+    return m_stolen;
+}
+
+void Executor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool Executor::pop(size_t index, Job& job)
+{
+    {
+        auto&                       own = *m_workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.front());
+            own.jobs.pop_front();
+            return true;
+        }
+    }
+
+    // First pass skips busy victims, the second one waits for the ones which were busy
+    bool contended = false;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 1; i < m_workers.size(); ++i) {
+            auto&                        victim = *m_workers[(index + i) % m_workers.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+            if (pass == 0 && !lock.try_lock()) {
+                contended = true;
+                continue;
+            }
+            if (pass == 1) {
+                lock.lock();
+            }
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                ++m_stolen;
+                return true;
+            }
+        }
+        if (!contended) {
+            break;
+        }
+    }
+    return false;
+}
+
+void Executor::pin(size_t index)
+{
+    if (m_cpus.empty()) {
+        return;
+    }
+
+    uint32_t  cpu = m_cpus[index % m_cpus.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); err != 0) {
+        logWarn("Executor: cannot pin worker {} to cpu {}, error {}", index, cpu, err);
+    }
+}
+
+void Executor::work(size_t index)
+{
+    t_executor = this;
+    t_worker   = index;
+    pin(index);
+
+    while (true) {
+        Job job;
+        if (pop(index, job)) {
+            m_pending.fetch_sub(1);
+            try {
+                job();
+            } catch (const std::exception& e) {
+                logError("Executor: job failed: {}", e.what());
+            }
+            continue;
+        }
+
+        // All deques were seen empty, but a job is counted as pending a moment before it is queued and until its
+        // worker took it. Such window is short, so the worker gives up its time slice instead of spinning on the locks.
+        if (m_pending.load() > 0 && !m_stop) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [&]() {
+            return m_stop || m_pending.load() > 0;
+        });
+        m_sleeping.fetch_sub(1);
+
+        if (m_stop && !m_pending.load()) {
+            return;
+        }
+    }
+}
+
+} // namespace fty
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fty {
+
+/// Work-stealing executor.
+/// Every worker has own deque, so producers and workers do not fight for one shared queue. Jobs pushed from outside
+/// are spread over the workers round-robin, jobs pushed from a worker go to its own deque. Worker takes jobs from the
+/// front of its deque and, when it is empty, steals from the back of the others.
+class Executor
+{
+public:
+    using Job = std::function<void()>;
+
+public:
+    /// Zero workers means number of cores. If cpus are given, worker `i` is pinned to `cpus[i % cpus.size()]`.
+    explicit Executor(size_t workers = 0, const std::vector<uint32_t>& cpus = {});
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /// Queues the job. Jobs pushed after stop are dropped.
+    void push(Job&& job);
+
+    template <typename T, typename... Args>
+    void pushWorker(Args&&... args)
+    {
+        auto task = std::make_shared<T>(std::forward<Args>(args)...);
+        push([task]() {
+            (*task)();
+        });
+    }
+
+    size_t workers() const;
+    /// Number of queued jobs which are not started yet
+    size_t depth() const;
+    /// Number of jobs which were run by other worker than they were queued to
+    uint64_t stolen() const;
+
+    /// Stops the executor, queued jobs are finished before
+    void stop();
+
+private:
+    struct Worker
+    {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+        std::thread     thread;
+    };
+
+    void work(size_t index);
+    bool pop(size_t index, Job& job);
+    void pin(size_t index);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<uint32_t>                m_cpus;
+    std::atomic<size_t>                  m_next     = 0;
+    std::atomic<size_t>                  m_pending  = 0;
+    std::atomic<size_t>                  m_sleeping = 0;
+    std::atomic<uint64_t>                m_stolen   = 0;
+    std::atomic<bool>                    m_stop     = false;
+    std::mutex                           m_sleepMutex;
+    std::condition_variable              m_wake;
+};
+
+} // namespace fty
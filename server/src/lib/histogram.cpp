@@ -0,0 +1,109 @@
+#include "histogram.h"
+#include <algorithm>
+
+namespace fty {
+
+// =====================================================================================================================
+
+uint32_t Histogram::index(uint64_t value)
+{
+    if (value < SubBuckets) {
+        return uint32_t(value);
+    }
+    // Values of [2^msb, 2^(msb + 1)) are split into Half buckets
+    uint32_t shift = uint32_t(63 - __builtin_clzll(value)) - (SubBits - 1);
+    return shift * Half + uint32_t(value >> shift);
+}
+
+uint64_t Histogram::upperBound(uint32_t index)
+{
+    if (index < SubBuckets) {
+        return index;
+    }
+    uint32_t shift = index / Half - 1;
+    uint64_t sub   = index - shift * Half;
+    return ((sub + 1) << shift) - 1;
+}
+
+// =====================================================================================================================
+
+void Histogram::record(uint64_t value)
+{
+    value = std::min(value, MaxValue);
+
+    m_buckets[index(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t cur = m_min.load(std::memory_order_relaxed);
+    while (value < cur && !m_min.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+    }
+    cur = m_max.load(std::memory_order_relaxed);
+    while (value > cur && !m_max.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::record(std::chrono::steady_clock::duration duration)
+{
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    record(uint64_t(std::max<int64_t>(usec, 0)));
+}
+
+uint64_t Histogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::min() const
+{
+    return count() ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t Histogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::sum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+double Histogram::mean() const
+{
+    uint64_t cnt = count();
+    return cnt ? double(m_sum.load(std::memory_order_relaxed)) / double(cnt) : 0.;
+}
+
+uint64_t Histogram::percentile(double percent) const
+{
+    uint64_t cnt = count();
+    if (!cnt) {
+        return 0;
+    }
+
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(double(cnt) * std::clamp(percent, 0., 100.) / 100. + 0.5));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < Buckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(upperBound(i), max());
+        }
+    }
+    return max();
+}
+
+void Histogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count = 0;
+    m_sum   = 0;
+    m_min   = UINT64_MAX;
+    m_max   = 0;
+}
+
+// =====================================================================================================================
+
+} // namespace fty
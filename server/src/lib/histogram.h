@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace fty {
+
+/// Lock-free latency histogram with HDR-like log-linear buckets.
+/// Every power of two range is split into 16 buckets, so the relative error of reported values is below 1/16. Values
+/// are microseconds, larger ones than MaxValue are counted as MaxValue.
+class Histogram
+{
+public:
+    static constexpr uint64_t MaxValue = uint64_t(1) << 36; // ~19 hours
+
+public:
+    void record(uint64_t value);
+    void record(std::chrono::steady_clock::duration duration);
+
+    uint64_t count() const;
+    uint64_t min() const;
+    uint64_t max() const;
+    uint64_t sum() const;
+    double   mean() const;
+
+    /// Value which is not exceeded by given percent of recorded values, i.e. percentile(99)
+    uint64_t percentile(double percent) const;
+
+    void reset();
+
+private:
+    static constexpr uint32_t SubBits    = 5;
+    static constexpr uint32_t SubBuckets = 1 << SubBits;
+    static constexpr uint32_t Half       = SubBuckets / 2;
+    static constexpr uint32_t Buckets    = (36 - (SubBits - 1)) * Half + SubBuckets; // covers index(MaxValue)
+
+    static uint32_t index(uint64_t value);
+    static uint64_t upperBound(uint32_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, Buckets> m_buckets = {};
+    std::atomic<uint64_t>                      m_count   = 0;
+    std::atomic<uint64_t>                      m_sum     = 0;
+    std::atomic<uint64_t>                      m_min     = UINT64_MAX;
+    std::atomic<uint64_t>                      m_max     = 0;
+};
+
+} // namespace fty
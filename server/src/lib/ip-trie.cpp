@@ -0,0 +1,187 @@
+#include "ip-trie.h"
+
+namespace fty {
+
+// =====================================================================================================================
+
+static std::optional<uint32_t> octet(std::string_view str)
+{
+    if (str.empty() || str.size() > 3) {
+        return std::nullopt;
+    }
+    uint32_t ret = 0;
+    for (char ch : str) {
+        if (ch < '0' || ch > '9') {
+            return std::nullopt;
+        }
+        ret = ret * 10 + uint32_t(ch - '0');
+    }
+    if (ret > 255) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+/// Splits [first, last] into the smallest set of aligned networks
+static std::vector<Cidr> range(uint32_t first, uint32_t last)
+{
+    std::vector<Cidr> ret;
+
+    uint64_t from = first;
+    while (from <= last) {
+        uint8_t length = 32;
+        while (length > 0) {
+            uint64_t size = uint64_t(1) << (32 - length + 1);
+            if ((from & (size - 1)) != 0 || from + size - 1 > last) {
+                break;
+            }
+            --length;
+        }
+        ret.push_back({uint32_t(from), length});
+        from += uint64_t(1) << (32 - length);
+    }
+
+    return ret;
+}
+
+// =====================================================================================================================
+
+uint32_t Cidr::first() const
+{
+    return length == 0 ? 0 : address & ~((uint64_t(1) << (32 - length)) - 1);
+}
+
+uint32_t Cidr::last() const
+{
+    return uint32_t(first() | ((uint64_t(1) << (32 - length)) - 1));
+}
+
+// =====================================================================================================================
+
+std::optional<uint32_t> IpTrie::address(std::string_view addr)
+{
+    uint32_t ret = 0;
+    for (int i = 0; i < 4; ++i) {
+        size_t pos = i < 3 ? addr.find('.') : addr.size();
+        if (pos == std::string_view::npos) {
+            return std::nullopt;
+        }
+        auto oct = octet(addr.substr(0, pos));
+        if (!oct) {
+            return std::nullopt;
+        }
+        ret  = ret << 8 | *oct;
+        addr = i < 3 ? addr.substr(pos + 1) : std::string_view();
+    }
+    return ret;
+}
+
+std::optional<std::vector<Cidr>> IpTrie::parse(std::string_view pattern)
+{
+    if (size_t pos = pattern.find('/'); pos != std::string_view::npos) {
+        auto addr   = address(pattern.substr(0, pos));
+        auto length = octet(pattern.substr(pos + 1));
+        if (!addr || !length || *length > 32) {
+            return std::nullopt;
+        }
+        return std::vector<Cidr>{{*addr, uint8_t(*length)}};
+    }
+
+    if (size_t pos = pattern.find('-'); pos != std::string_view::npos) {
+        auto first = address(pattern.substr(0, pos));
+        auto last  = address(pattern.substr(pos + 1));
+        if (!first || !last || *first > *last) {
+            return std::nullopt;
+        }
+        return range(*first, *last);
+    }
+
+    if (size_t pos = pattern.find('*'); pos != std::string_view::npos) {
+        // Only whole octets could be wildcarded, `10.1*` is left to string matching
+        if (pos != 0 && pattern[pos - 1] != '.') {
+            return std::nullopt;
+        }
+        for (size_t i = pos; i < pattern.size(); ++i) {
+            if (pattern[i] != '*' && pattern[i] != '.') {
+                return std::nullopt;
+            }
+        }
+
+        uint32_t         addr   = 0;
+        uint8_t          length = 0;
+        std::string_view prefix = pattern.substr(0, pos);
+        while (!prefix.empty()) {
+            size_t dot = prefix.find('.');
+            auto   oct = octet(prefix.substr(0, dot));
+            if (!oct || dot == std::string_view::npos || length == 24) {
+                return std::nullopt;
+            }
+            addr |= *oct << (24 - length);
+            length += 8;
+            prefix = prefix.substr(dot + 1);
+        }
+        return std::vector<Cidr>{{addr, length}};
+    }
+
+    if (auto addr = address(pattern)) {
+        return std::vector<Cidr>{{*addr, 32}};
+    }
+    return std::nullopt;
+}
+
+// =====================================================================================================================
+
+void IpTrie::insert(const Cidr& cidr)
+{
+    if (m_nodes.empty()) {
+        m_nodes.emplace_back();
+    }
+
+    uint32_t node = 0;
+    uint32_t addr = cidr.first();
+    for (uint8_t i = 0; i < cidr.length; ++i) {
+        if (m_nodes[node].terminal) {
+            // Already covered by wider network
+            return;
+        }
+        uint32_t bit = (addr >> (31 - i)) & 1;
+        if (!m_nodes[node].child[bit]) {
+            m_nodes[node].child[bit] = uint32_t(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+        node = m_nodes[node].child[bit];
+    }
+    m_nodes[node].terminal = true;
+}
+
+bool IpTrie::match(uint32_t address) const
+{
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    uint32_t node = 0;
+    for (int i = 0; i < 32; ++i) {
+        if (m_nodes[node].terminal) {
+            return true;
+        }
+        node = m_nodes[node].child[(address >> (31 - i)) & 1];
+        if (!node) {
+            return false;
+        }
+    }
+    return m_nodes[node].terminal;
+}
+
+bool IpTrie::match(std::string_view address) const
+{
+    auto addr = IpTrie::address(address);
+    return addr && match(*addr);
+}
+
+bool IpTrie::empty() const
+{
+    return m_nodes.empty();
+}
+
+} // namespace fty
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace fty {
+
+/// IPv4 network: address and prefix length
+struct Cidr
+{
+    uint32_t address = 0;
+    uint8_t  length  = 32;
+
+    uint32_t first() const;
+    uint32_t last() const;
+};
+
+/// Binary radix trie of IPv4 networks.
+/// Lookup of an address takes at most 32 steps regardless of how many networks were inserted.
+class IpTrie
+{
+public:
+    /// Parses address pattern into networks. Supported patterns:
+    ///  * address: `10.0.0.1`
+    ///  * network: `10.0.0.0/8`
+    ///  * range: `10.0.0.1-10.0.0.20`
+    ///  * octet wildcard: `10.0.*` or `10.0.*.*`
+    /// Returns nullopt if pattern is not IPv4 one.
+    static std::optional<std::vector<Cidr>> parse(std::string_view pattern);
+
+    /// Parses dotted IPv4 address
+    static std::optional<uint32_t> address(std::string_view addr);
+
+public:
+    void insert(const Cidr& cidr);
+    bool match(uint32_t address) const;
+    bool match(std::string_view address) const;
+    bool empty() const;
+
+private:
+    struct Node
+    {
+        uint32_t child[2] = {0, 0};
+        bool     terminal = false;
+    };
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+} // namespace fty
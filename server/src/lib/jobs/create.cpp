@@ -1,4 +1,5 @@
 #include "create.h"
+#include "lib/membership.h"
 #include "lib/storage.h"
 
 namespace fty::job {
@@ -9,7 +10,10 @@ void Create::run(const commands::create::In& in, commands::create::Out& out)
         throw Error(ret.error());
     } else {
         out = *ret;
-        notify(commands::notify::Created, ret->id);
+        if (auto upd = Membership::update(*ret); !upd) {
+            logError("Cannot update membership of group {}: {}", ret->id.value(), upd.error());
+        }
+        notify(commands::notify::Created, ret->id.value());
     }
 }
 
@@ -0,0 +1,15 @@
+#include "membership-of.h"
+#include "lib/membership.h"
+
+namespace fty::job {
+
+void MembershipOf::run(const commands::membership::In& in, commands::membership::Out& out)
+{
+    if (auto ret = Membership::groupsOf(in.id)) {
+        out = *ret;
+    } else {
+        throw Error(ret.error());
+    }
+}
+
+} // namespace fty::job
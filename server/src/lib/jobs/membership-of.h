@@ -0,0 +1,13 @@
+#pragma once
+#include "lib/task.h"
+
+namespace fty::job {
+
+class MembershipOf : public Task<MembershipOf, commands::membership::In, commands::membership::Out>
+{
+public:
+    using Task::Task;
+    void run(const commands::membership::In& in, commands::membership::Out& out);
+};
+
+} // namespace fty::job
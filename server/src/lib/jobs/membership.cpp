@@ -0,0 +1,64 @@
+#include "membership.h"
+#include "common/logger.h"
+#include "lib/asset-index.h"
+#include "lib/membership.h"
+
+namespace fty::job {
+
+struct AssetInfo : public pack::Node
+{
+    pack::String id = FIELD("id");
+
+    using pack::Node::Node;
+    META(AssetInfo, id);
+};
+
+/// Asset event payload, updates are sent as before/after pair
+struct AssetEvent : public pack::Node
+{
+    pack::String id    = FIELD("id");
+    AssetInfo    after = FIELD("after");
+
+    using pack::Node::Node;
+    META(AssetEvent, id, after);
+};
+
+AssetChanged::AssetChanged(const Message& msg)
+    : m_in(msg)
+{
+}
+
+void AssetChanged::operator()()
+{
+    auto event = m_in.userData.decode<AssetEvent>();
+    if (!event) {
+        logWarn("Cannot decode asset event {}: {}, full refresh", m_in.meta.subject.value(), event.error());
+        if (auto ret = AssetIndex::reload(); !ret) {
+            logError(ret.error());
+        }
+        if (auto ret = Membership::refresh(); !ret) {
+            logError(ret.error());
+        }
+        return;
+    }
+
+    std::string name = event->after.id.hasValue() ? event->after.id.value() : event->id.value();
+    if (auto ret = AssetIndex::assetChanged(name); !ret) {
+        logError(ret.error());
+    }
+    if (auto ret = Membership::assetChanged(name); !ret) {
+        logError(ret.error());
+    }
+}
+
+void RefreshMembership::operator()()
+{
+    if (auto ret = AssetIndex::reload(); !ret) {
+        logError(ret.error());
+    }
+    if (auto ret = Membership::refresh(); !ret) {
+        logError(ret.error());
+    }
+}
+
+} // namespace fty::job
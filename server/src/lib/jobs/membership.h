@@ -0,0 +1,25 @@
+#pragma once
+#include "common/message.h"
+#include <fty/thread-pool.h>
+
+namespace fty::job {
+
+/// Reevaluates membership of the asset from asset event
+class AssetChanged : public fty::Task<AssetChanged>
+{
+public:
+    explicit AssetChanged(const Message& msg);
+    void operator()() override;
+
+private:
+    Message m_in;
+};
+
+/// Rebuilds membership of all groups
+class RefreshMembership : public fty::Task<RefreshMembership>
+{
+public:
+    void operator()() override;
+};
+
+} // namespace fty::job
@@ -0,0 +1,50 @@
+#include "read-many.h"
+#include "lib/storage.h"
+#include <algorithm>
+
+namespace fty::job {
+
+void ReadMany::run(const commands::readMany::In& cmd, commands::readMany::Out& out)
+{
+    auto order = commands::Order::parse(cmd.sort.value());
+    if (!order) {
+        throw Error("Unknown sort '{}'", cmd.sort.value());
+    }
+    for (const auto& field : cmd.fields) {
+        if (!commands::readMany::isField(field)) {
+            throw Error("Unknown field '{}'", field);
+        }
+    }
+
+    std::vector<Group> groups;
+    if (cmd.all) {
+        groups = Storage::all();
+    } else {
+        std::vector<uint64_t> ids;
+        for (const auto& id : cmd.ids) {
+            ids.push_back(id);
+        }
+        groups = Storage::byIds(ids);
+    }
+
+    if (!cmd.sort.empty()) {
+        std::stable_sort(groups.begin(), groups.end(), [&](const Group& l, const Group& r) {
+            return (*order)(l.id.value(), l.name.value(), r.id.value(), r.name.value());
+        });
+    }
+
+    bool   rules = cmd.fields.empty() || commands::contains(cmd.fields, "rules");
+    size_t first = std::min<size_t>(cmd.offset.value(), groups.size());
+    size_t last  = cmd.limit.value() ? std::min<size_t>(first + cmd.limit.value(), groups.size()) : groups.size();
+    for (size_t i = first; i < last; ++i) {
+        if (rules) {
+            out.append(groups[i]);
+        } else {
+            auto& brief = out.append();
+            brief.id    = groups[i].id.value();
+            brief.name  = groups[i].name.value();
+        }
+    }
+}
+
+} // namespace fty::job
@@ -0,0 +1,14 @@
+#pragma once
+#include "lib/task.h"
+
+namespace fty::job {
+
+/// Reads full definitions of many groups in one request
+class ReadMany : public Task<ReadMany, commands::readMany::In, commands::readMany::Out>
+{
+public:
+    using Task::Task;
+    void run(const commands::readMany::In& cmd, commands::readMany::Out& out);
+};
+
+} // namespace fty::job
@@ -1,4 +1,5 @@
 #include "remove.h"
+#include "lib/membership.h"
 #include "lib/storage.h"
 
 namespace fty::job {
@@ -11,9 +12,10 @@ void Remove::run(const commands::remove::In& in, commands::remove::Out& out)
             line.append(fty::convert<std::string>(id), ret.error());
         } else {
             line.append(fty::convert<std::string>(id), "Ok");
-            pack::UInt64 send;
-            send = id;
-            notify(commands::notify::Deleted, send);
+            if (auto rem = Membership::remove(id); !rem) {
+                logError("Cannot remove membership of group {}: {}", id, rem.error());
+            }
+            notify(commands::notify::Deleted, id);
         }
     }
 }
@@ -14,4 +14,11 @@ public:
     void run(const commands::resolve::In& groupId, commands::resolve::Out& assetList);
 };
 
+class ResolveCount : public Task<ResolveCount, commands::resolveCount::In, commands::resolveCount::Out>
+{
+public:
+    using Task::Task;
+    void run(const commands::resolveCount::In& in, commands::resolveCount::Out& out);
+};
+
 } // namespace fty::job
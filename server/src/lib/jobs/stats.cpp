@@ -0,0 +1,11 @@
+#include "stats.h"
+#include "lib/request-stats.h"
+
+namespace fty::job {
+
+void Stats::run(commands::stats::Out& out)
+{
+    out = RequestStats::instance().report();
+}
+
+} // namespace fty::job
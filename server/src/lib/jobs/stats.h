@@ -0,0 +1,13 @@
+#pragma once
+#include "lib/task.h"
+
+namespace fty::job {
+
+class Stats : public Task<Stats, void, commands::stats::Out>
+{
+public:
+    using Task::Task;
+    void run(commands::stats::Out& out);
+};
+
+} // namespace fty::job
@@ -1,4 +1,5 @@
 #include "update.h"
+#include "lib/membership.h"
 #include "lib/storage.h"
 
 namespace fty::job {
@@ -9,7 +10,10 @@ void Update::run(const commands::update::In& in, commands::update::Out& out)
         throw Error(ret.error());
     } else {
         out = *ret;
-        notify(commands::notify::Updated, ret->id);
+        if (auto upd = Membership::update(*ret); !upd) {
+            logError("Cannot update membership of group {}: {}", ret->id.value(), upd.error());
+        }
+        notify(commands::notify::Updated, ret->id.value());
     }
 }
 
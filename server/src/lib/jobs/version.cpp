@@ -0,0 +1,24 @@
+#include "version.h"
+#include "lib/asset-index.h"
+#include "lib/membership.h"
+#include "lib/storage.h"
+#include <chrono>
+
+namespace fty::job {
+
+/// Differs between daemon runs, so counters of a previous run are not taken for the current ones
+static uint64_t generation()
+{
+    static const uint64_t gen = uint64_t(std::chrono::system_clock::now().time_since_epoch().count());
+    return gen;
+}
+
+void Version::run(commands::version::Out& out)
+{
+    out.generation = generation();
+    out.groups     = Storage::version();
+    out.assets     = Membership::version();
+    out.index      = AssetIndex::version();
+}
+
+} // namespace fty::job
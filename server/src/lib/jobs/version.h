@@ -0,0 +1,13 @@
+#pragma once
+#include "lib/task.h"
+
+namespace fty::job {
+
+class Version : public Task<Version, void, commands::version::Out>
+{
+public:
+    using Task::Task;
+    void run(commands::version::Out& out);
+};
+
+} // namespace fty::job
@@ -0,0 +1,175 @@
+#include "lane.h"
+#include "common/logger.h"
+#include <algorithm>
+
+namespace fty {
+
+Lane::Lane(const std::string& name, size_t workers, size_t queueSize, Policy policy, std::chrono::milliseconds maxWait,
+    const std::vector<uint32_t>& cpus)
+    : m_name(name)
+    , m_queueSize(queueSize)
+    , m_policy(policy)
+    , m_maxWait(maxWait)
+    , m_executor(std::max<size_t>(workers, 1), cpus)
+{
+}
+
+Lane::~Lane()
+{
+    stop();
+}
+
+bool Lane::push(Job&& job, Job&& reject)
+{
+    if (m_stop) {
+        return false;
+    }
+
+    // Place in the queue is taken first, so concurrent producers never admit more jobs than the limit
+    std::shared_ptr<Item> shed;
+    size_t                queued = m_queued.fetch_add(1);
+    if (m_queueSize && queued >= m_queueSize) {
+        if (m_policy == Policy::Reject) {
+            m_queued.fetch_sub(1);
+            ++m_rejected;
+            return false;
+        }
+        shed = this->shed();
+    }
+
+    auto item    = std::make_shared<Item>();
+    item->job    = std::move(job);
+    item->reject = std::move(reject);
+    item->queued = std::chrono::steady_clock::now();
+
+    if (m_policy == Policy::ShedOldest && m_queueSize) {
+        std::lock_guard<std::mutex> lock(m_orderMutex);
+        // Started jobs are dropped from the front, so the order keeps about the queued jobs only
+        while (!m_order.empty() && m_order.front()->taken) {
+            m_order.pop_front();
+        }
+        m_order.push_back(item);
+    }
+
+    m_executor.push([this, item]() {
+        run(*item);
+    });
+
+    if (shed) {
+        logDebug("Lane {}: queue is full, the oldest job is shed", m_name);
+        this->reject(*shed);
+    }
+    return true;
+}
+
+std::shared_ptr<Lane::Item> Lane::shed()
+{
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    while (!m_order.empty()) {
+        auto item = std::move(m_order.front());
+        m_order.pop_front();
+        if (!item->taken.exchange(true)) {
+            m_queued.fetch_sub(1);
+            return item;
+        }
+    }
+    // Everything was started meanwhile, so there is a place already
+    return nullptr;
+}
+
+size_t Lane::depth() const
+{
+    return m_queued;
+}
+
+size_t Lane::queueSize() const
+{
+    return m_queueSize;
+}
+
+const std::string& Lane::name() const
+{
+    return m_name;
+}
+
+size_t Lane::rejected() const
+{
+    return m_rejected;
+}
+
+uint64_t Lane::stolen() const
+{
+    return m_executor.stolen();
+}
+
+void Lane::stop()
+{
+    m_stop = true;
+    // Queued jobs are finished
+    m_executor.stop();
+}
+
+void Lane::reject(Item& item)
+{
+    ++m_rejected;
+    if (!item.reject) {
+        return;
+    }
+    try {
+        item.reject();
+    } catch (const std::exception& e) {
+        logError("Lane {}: reject failed: {}", m_name, e.what());
+    }
+}
+
+void Lane::run(Item& item)
+{
+    // Shed while it was queued
+    if (item.taken.exchange(true)) {
+        return;
+    }
+    m_queued.fetch_sub(1);
+
+    // Client has most probably given up waiting for this one
+    if (m_maxWait.count() && std::chrono::steady_clock::now() - item.queued > m_maxWait) {
+        logDebug("Lane {}: job waited longer than {} ms, skipped", m_name, m_maxWait.count());
+        reject(item);
+        return;
+    }
+
+    try {
+        item.job();
+    } catch (const std::exception& e) {
+        logError("Lane {}: job failed: {}", m_name, e.what());
+    }
+}
+
+// =====================================================================================================================
+
+std::ostream& operator<<(std::ostream& ss, Lane::Policy value)
+{
+    ss << [&]() {
+        switch (value) {
+            case Lane::Policy::Reject:
+                return "reject";
+            case Lane::Policy::ShedOldest:
+                return "shed-oldest";
+        }
+        return "unknown";
+    }();
+    return ss;
+}
+
+std::istream& operator>>(std::istream& ss, Lane::Policy& value)
+{
+    std::string strval;
+    ss >> strval;
+    if (strval == "reject") {
+        value = Lane::Policy::Reject;
+    } else if (strval == "shed-oldest") {
+        value = Lane::Policy::ShedOldest;
+    }
+    return ss;
+}
+
+} // namespace fty
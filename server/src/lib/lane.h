@@ -0,0 +1,97 @@
+#pragma once
+#include "executor.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fty {
+
+/// Worker lane: own workers and bounded admission of jobs.
+/// Subjects are spread over the lanes, so slow jobs in one lane never delay jobs of the other lanes.
+/// Jobs run on work-stealing Executor of the lane, so producers and workers do not fight for one queue. Queue limit
+/// and policy are admission control in front of it: jobs which are not admitted (full queue, shed from queue or waited
+/// longer than allowed) are not run, their reject callback is called instead.
+class Lane
+{
+public:
+    using Job = std::function<void()>;
+
+    /// What to do with a new job if the queue is full
+    enum class Policy
+    {
+        Reject,     // reject the new job
+        ShedOldest, // reject the oldest queued job and queue the new one
+    };
+
+public:
+    /// If cpus are given, worker `i` is pinned to `cpus[i % cpus.size()]`, see Executor
+    Lane(const std::string& name, size_t workers, size_t queueSize, Policy policy = Policy::Reject,
+        std::chrono::milliseconds maxWait = std::chrono::milliseconds(0), const std::vector<uint32_t>& cpus = {});
+    ~Lane();
+
+    /// Queues the job, returns false if the job was not admitted. Reject callback is not called in this case.
+    [[nodiscard]] bool push(Job&& job, Job&& reject = {});
+
+    template <typename T, typename... Args>
+    [[nodiscard]] bool pushWorker(Job&& reject, Args&&... args)
+    {
+        auto task = std::make_shared<T>(std::forward<Args>(args)...);
+        return push(
+            [task]() {
+                (*task)();
+            },
+            std::move(reject));
+    }
+
+    /// Number of queued jobs which are not started yet
+    size_t             depth() const;
+    size_t             queueSize() const;
+    const std::string& name() const;
+    /// Number of jobs which were not admitted or were shed
+    size_t             rejected() const;
+    /// Number of jobs which were run by other worker than they were queued to
+    uint64_t           stolen() const;
+
+    /// Stops the lane, queued jobs are finished before
+    void stop();
+
+private:
+    struct Item
+    {
+        Job                                   job;
+        Job                                   reject;
+        std::chrono::steady_clock::time_point queued;
+        std::atomic<bool>                     taken = false; // started by a worker or shed
+    };
+
+    void run(Item& item);
+    void reject(Item& item);
+    /// Takes over the oldest queued job, if any
+    std::shared_ptr<Item> shed();
+
+private:
+    std::string               m_name;
+    size_t                    m_queueSize;
+    Policy                    m_policy;
+    std::chrono::milliseconds m_maxWait;
+    std::atomic<size_t>       m_queued   = 0;
+    std::atomic<bool>         m_stop     = false;
+    std::atomic<size_t>       m_rejected = 0;
+
+    // Admission order of queued jobs, kept only by shed-oldest lanes
+    std::mutex                        m_orderMutex;
+    std::deque<std::shared_ptr<Item>> m_order;
+
+    Executor m_executor;
+};
+
+std::ostream& operator<<(std::ostream& ss, Lane::Policy value);
+std::istream& operator>>(std::istream& ss, Lane::Policy& value);
+
+} // namespace fty
@@ -0,0 +1,597 @@
+#include "membership.h"
+#include "config.h"
+#include "evaluator.h"
+#include "metrics.h"
+#include "query.h"
+#include "storage.h"
+#include <asset/db.h>
+#include <atomic>
+#include <fty_common_asset_types.h>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace fty {
+
+using namespace fmt::literals;
+
+// =====================================================================================================================
+
+static constexpr const char* CreateTable = R"(
+    CREATE TABLE IF NOT EXISTS t_bios_group_member (
+        group_id BIGINT UNSIGNED NOT NULL,
+        asset_id INT UNSIGNED NOT NULL,
+        PRIMARY KEY (group_id, asset_id),
+        INDEX (asset_id),
+        FOREIGN KEY (asset_id) REFERENCES t_bios_asset_element (id_asset_element) ON DELETE CASCADE
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8
+)";
+
+using Ids = std::set<uint64_t>;
+
+/// Maximum number of ids in one `IN (...)` list
+static constexpr size_t ChunkSize = 1000;
+
+static void connect()
+{
+    // Normal connect in _this_ thread, otherwise tntdb will fail
+    tntdb::connect(getenv("DBURL") ? getenv("DBURL") : DBConn::url);
+}
+
+static bool tableEnabled()
+{
+    return Config::instance().membershipTable.value();
+}
+
+static Ids selectIds(tnt::Connection& conn, const std::string& sql)
+{
+    Metrics::Timer timer(Metrics::instance().dbQuery);
+
+    Ids ids;
+    for (const auto& row : conn.select(sql)) {
+        ids.insert(row.get<uint64_t>("id"));
+    }
+    return ids;
+}
+
+/// Splits ids into comma separated lists of at most `ChunkSize` ids
+template <typename IdsT>
+static std::vector<std::string> chunks(const IdsT& ids)
+{
+    std::vector<std::string> ret;
+    std::vector<uint64_t>    chunk;
+    for (const auto& id : ids) {
+        chunk.push_back(id);
+        if (chunk.size() == ChunkSize) {
+            ret.push_back(fty::implode(chunk, ","));
+            chunk.clear();
+        }
+    }
+    if (!chunk.empty()) {
+        ret.push_back(fty::implode(chunk, ","));
+    }
+    return ret;
+}
+
+static std::vector<Group> groups()
+{
+    std::vector<Group> ret;
+    for (const auto& id : Storage::ids()) {
+        if (auto group = Storage::byId(id)) {
+            ret.push_back(*group);
+        }
+    }
+    return ret;
+}
+
+/// Selects assets matched by the group, only from `scope` if it's not empty
+static Ids members(tnt::Connection& conn, const Group& group, const Ids& scope = {})
+{
+    std::string sql = R"(
+        SELECT
+            id_asset_element AS id
+        FROM t_bios_asset_element
+        WHERE {})"_format(query::where(conn, group.rules));
+
+    if (!scope.empty()) {
+        sql += " AND id_asset_element IN ({})"_format(fty::implode(scope, ","));
+    }
+    return selectIds(conn, sql);
+}
+
+/// Loads attributes used by group rules for the assets
+static std::vector<AssetRecord> loadAssets(tnt::Connection& conn, const Ids& ids)
+{
+    Metrics::Timer timer(Metrics::instance().dbQuery);
+
+    std::vector<AssetRecord>             records;
+    std::unordered_map<uint64_t, size_t> index;
+
+    std::string list = fty::implode(ids, ",");
+
+    for (const auto& row : conn.select(R"(
+        SELECT
+            e.id_asset_element AS id,
+            e.id_type AS type,
+            COALESCE(t.name, '') AS subtype
+        FROM
+            t_bios_asset_element AS e
+        LEFT JOIN t_bios_asset_device_type AS t
+            ON e.id_subtype = t.id_asset_device_type
+        WHERE e.id_asset_element IN ({}))"_format(list))) {
+        AssetRecord rec;
+        rec.id     = row.get<uint64_t>("id");
+        rec.device = row.get<uint16_t>("type") == persist::DEVICE;
+        rec.type   = row.get("subtype");
+
+        index[rec.id] = records.size();
+        records.push_back(std::move(rec));
+    }
+
+    for (const auto& row : conn.select(R"(
+        SELECT
+            id_asset_element AS id,
+            keytag,
+            value
+        FROM
+            t_bios_asset_ext_attributes
+        WHERE
+            id_asset_element IN ({}) AND
+            (keytag IN ('name', 'device.contact', 'contact_email', 'hostname.1') OR
+            keytag LIKE 'ip.%'))"_format(list))) {
+        auto it = index.find(row.get<uint64_t>("id"));
+        if (it == index.end()) {
+            continue;
+        }
+
+        auto&       rec = records[it->second];
+        std::string key = row.get("keytag");
+        if (key == "name") {
+            rec.name = row.get("value");
+        } else if (key == "hostname.1") {
+            rec.hostName = row.get("value");
+        } else if (key.compare(0, 3, "ip.") == 0) {
+            rec.ips.push_back(row.get("value"));
+        } else {
+            rec.contacts.push_back(row.get("value"));
+        }
+    }
+
+    for (const auto& row : conn.select(R"(
+        SELECT
+            p.id_asset_element AS id,
+            d.name
+        FROM
+            v_bios_asset_element_super_parent AS p
+        JOIN t_bios_asset_element AS d
+            ON d.id_type = {} AND d.id_asset_element IN (p.id_parent1, p.id_parent2, p.id_parent3, p.id_parent4,
+            p.id_parent5, p.id_parent6, p.id_parent7, p.id_parent8, p.id_parent9, p.id_parent10)
+        WHERE p.id_asset_element IN ({}))"_format(persist::DATACENTER, list))) {
+        if (auto it = index.find(row.get<uint64_t>("id")); it != index.end()) {
+            records[it->second].locations.push_back(row.get("name"));
+        }
+    }
+
+    return records;
+}
+
+// =====================================================================================================================
+
+class Membership::Impl
+{
+public:
+    /// Makes members of the group within `scope` (or all members if scope is empty) equal to `members`
+    void apply(tnt::Connection& conn, const Group& group, const Ids& members, const Ids& scope = {})
+    {
+        std::vector<uint64_t> toRemove;
+        std::vector<uint64_t> toAdd;
+        {
+            std::shared_lock<std::shared_mutex> lock(indexMutex);
+
+            static const Ids empty;
+            auto             it      = groupAssets.find(group.id);
+            const Ids&       current = it != groupAssets.end() ? it->second : empty;
+
+            for (const auto& id : scope.empty() ? current : scope) {
+                if (current.count(id) && !members.count(id)) {
+                    toRemove.push_back(id);
+                }
+            }
+            for (const auto& id : members) {
+                if (!current.count(id)) {
+                    toAdd.push_back(id);
+                }
+            }
+        }
+
+        if (tableEnabled()) {
+            for (const auto& list : chunks(toRemove)) {
+                conn.execute("DELETE FROM t_bios_group_member WHERE group_id = {} AND asset_id IN ({})"_format(
+                    group.id.value(), list));
+            }
+
+            if (!toAdd.empty()) {
+                std::vector<std::string> values;
+                for (const auto& id : toAdd) {
+                    values.push_back("({}, {})"_format(group.id.value(), id));
+                }
+                conn.execute("INSERT IGNORE INTO t_bios_group_member (group_id, asset_id) VALUES {}"_format(
+                    fty::implode(values, ",")));
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(indexMutex);
+
+        auto& assets    = groupAssets[group.id];
+        names[group.id] = group.name;
+        for (const auto& id : toRemove) {
+            assets.erase(id);
+            unlink(id, group.id);
+        }
+        for (const auto& id : toAdd) {
+            assets.insert(id);
+            assetGroups[id].insert(group.id);
+        }
+
+        if (!toRemove.empty() || !toAdd.empty()) {
+            ++version;
+        }
+    }
+
+    /// Compiles rules of the group, so asset changes can be evaluated in process
+    void compile(const Group& group)
+    {
+        if (auto eval = Evaluator::compile(group.rules)) {
+            programs.insert_or_assign(group.id, std::move(*eval));
+        } else {
+            programs.erase(group.id);
+        }
+    }
+
+    /// Selects assets matched by the group from `scope`
+    Ids match(tnt::Connection& conn, const Group& group, const std::vector<AssetRecord>& records, const Ids& scope)
+    {
+        auto it = programs.find(group.id);
+        if (it == programs.end()) {
+            return members(conn, group, scope);
+        }
+
+        Ids ret;
+        for (const auto& rec : records) {
+            if (it->second.match(rec)) {
+                ret.insert(rec.id);
+            }
+        }
+        return ret;
+    }
+
+    void erase(tnt::Connection& conn, uint64_t groupId)
+    {
+        programs.erase(groupId);
+
+        if (tableEnabled()) {
+            conn.execute("DELETE FROM t_bios_group_member WHERE group_id = {}"_format(groupId));
+        }
+
+        std::unique_lock<std::shared_mutex> lock(indexMutex);
+        if (auto it = groupAssets.find(groupId); it != groupAssets.end()) {
+            for (const auto& id : it->second) {
+                unlink(id, groupId);
+            }
+            groupAssets.erase(it);
+        }
+        names.erase(groupId);
+        ++version;
+    }
+
+    /// Drops removed assets from the index, table is cleaned up by foreign key
+    void purge(tnt::Connection& conn)
+    {
+        std::vector<uint64_t> indexed;
+        {
+            std::shared_lock<std::shared_mutex> lock(indexMutex);
+            for (const auto& it : assetGroups) {
+                indexed.push_back(it.first);
+            }
+        }
+
+        if (indexed.empty()) {
+            return;
+        }
+
+        Ids exists;
+        for (const auto& list : chunks(indexed)) {
+            auto ids = selectIds(conn, R"(
+                SELECT
+                    id_asset_element AS id
+                FROM t_bios_asset_element
+                WHERE id_asset_element IN ({}))"_format(list));
+            exists.insert(ids.begin(), ids.end());
+        }
+
+        std::unique_lock<std::shared_mutex> lock(indexMutex);
+        for (const auto& id : indexed) {
+            if (exists.count(id)) {
+                continue;
+            }
+            if (auto it = assetGroups.find(id); it != assetGroups.end()) {
+                for (const auto& groupId : it->second) {
+                    groupAssets[groupId].erase(id);
+                }
+                assetGroups.erase(it);
+            }
+        }
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(indexMutex);
+        groupAssets.clear();
+        assetGroups.clear();
+        names.clear();
+    }
+
+public:
+    std::mutex        mutex;
+    std::shared_mutex indexMutex;
+    std::atomic<bool>     ready      = false;
+    std::atomic<bool>     tableReady = false;
+    std::atomic<uint64_t> version    = 0;
+
+    std::unordered_map<uint64_t, Ids>         groupAssets;
+    std::unordered_map<uint64_t, Ids>         assetGroups;
+    std::unordered_map<uint64_t, std::string> names;
+    std::unordered_map<uint64_t, Evaluator>   programs;
+
+private:
+    void unlink(uint64_t assetId, uint64_t groupId)
+    {
+        if (auto it = assetGroups.find(assetId); it != assetGroups.end()) {
+            it->second.erase(groupId);
+            if (it->second.empty()) {
+                assetGroups.erase(it);
+            }
+        }
+    }
+};
+
+// =====================================================================================================================
+
+Membership& Membership::instance()
+{
+    static Membership inst;
+    return inst;
+}
+
+Membership::Membership()
+    : m_impl(new Impl)
+{
+}
+
+Membership::~Membership()
+{
+}
+
+bool Membership::ready()
+{
+    return instance().m_impl->ready;
+}
+
+Membership::Counts Membership::counts()
+{
+    auto&                               impl = *instance().m_impl;
+    std::shared_lock<std::shared_mutex> lock(impl.indexMutex);
+
+    Counts ret;
+    ret.groups = impl.groupAssets.size();
+    for (const auto& it : impl.groupAssets) {
+        ret.members += it.second.size();
+    }
+    return ret;
+}
+
+uint64_t Membership::version()
+{
+    return instance().m_impl->version;
+}
+
+bool Membership::tableReady()
+{
+    return tableEnabled() && instance().m_impl->tableReady;
+}
+
+Expected<void> Membership::refresh()
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.mutex);
+
+    impl.ready      = false;
+    impl.tableReady = false;
+
+    try {
+        connect();
+        tnt::Connection conn;
+
+        impl.clear();
+
+        // Start from the table state, so only difference will be written
+        if (tableEnabled()) {
+            conn.execute(CreateTable);
+
+            std::unique_lock<std::shared_mutex> lock(impl.indexMutex);
+            for (const auto& row : conn.select("SELECT group_id, asset_id FROM t_bios_group_member")) {
+                auto groupId = row.get<uint64_t>("group_id");
+                auto assetId = row.get<uint64_t>("asset_id");
+                impl.groupAssets[groupId].insert(assetId);
+                impl.assetGroups[assetId].insert(groupId);
+            }
+        }
+
+        Ids ids;
+        for (const auto& group : groups()) {
+            impl.compile(group);
+            impl.apply(conn, group, members(conn, group));
+            ids.insert(group.id);
+        }
+
+        std::vector<uint64_t> stale;
+        {
+            std::shared_lock<std::shared_mutex> lock(impl.indexMutex);
+            for (const auto& it : impl.groupAssets) {
+                if (!ids.count(it.first)) {
+                    stale.push_back(it.first);
+                }
+            }
+        }
+        for (const auto& id : stale) {
+            impl.erase(conn, id);
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+
+    impl.ready      = true;
+    impl.tableReady = tableEnabled();
+    ++impl.version;
+    return {};
+}
+
+Expected<void> Membership::update(const Group& group)
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.mutex);
+
+    try {
+        connect();
+        tnt::Connection conn;
+        impl.compile(group);
+        impl.apply(conn, group, members(conn, group));
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+    return {};
+}
+
+Expected<void> Membership::remove(uint64_t groupId)
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.mutex);
+
+    try {
+        connect();
+        tnt::Connection conn;
+        impl.erase(conn, groupId);
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+    return {};
+}
+
+Expected<void> Membership::assetChanged(const std::string& assetName)
+{
+    auto&                       impl = *instance().m_impl;
+    std::lock_guard<std::mutex> guard(impl.mutex);
+
+    try {
+        connect();
+        tnt::Connection conn;
+
+        Ids scope;
+        for (const auto& row : conn.select(
+                 "SELECT id_asset_element FROM t_bios_asset_element WHERE name = :name", "name"_p = assetName)) {
+            scope.insert(row.get<uint64_t>("id_asset_element"));
+        }
+
+        if (scope.empty()) {
+            impl.purge(conn);
+            ++impl.version;
+            return {};
+        }
+
+        // Location of contained assets could be changed as well
+        auto children = selectIds(conn, R"(
+            SELECT
+                p.id_asset_element AS id
+            FROM
+                v_bios_asset_element_super_parent p
+            WHERE
+                {0} in (p.id_parent1, p.id_parent2, p.id_parent3, p.id_parent4, p.id_parent5,
+                p.id_parent6, p.id_parent7, p.id_parent8, p.id_parent9, p.id_parent10)
+        )"_format(*scope.begin()));
+        scope.insert(children.begin(), children.end());
+
+        auto records = loadAssets(conn, scope);
+        for (const auto& group : groups()) {
+            impl.apply(conn, group, impl.match(conn, group, records, scope), scope);
+        }
+    } catch (const std::exception& e) {
+        ++impl.version;
+        return unexpected(e.what());
+    }
+
+    // Data of the asset changed even if membership did not, so answers built of assets are outdated anyway
+    ++impl.version;
+    return {};
+}
+
+Expected<commands::membership::Out> Membership::groupsOf(uint64_t assetId)
+{
+    auto& impl = *instance().m_impl;
+
+    commands::membership::Out out;
+    if (impl.ready) {
+        std::shared_lock<std::shared_mutex> lock(impl.indexMutex);
+        if (auto it = impl.assetGroups.find(assetId); it != impl.assetGroups.end()) {
+            for (const auto& groupId : it->second) {
+                auto& line = out.append();
+                line.id    = groupId;
+                if (auto name = impl.names.find(groupId); name != impl.names.end()) {
+                    line.name = name->second;
+                }
+            }
+        }
+        return std::move(out);
+    }
+
+    // Index is not built yet, check groups one by one
+    try {
+        connect();
+        tnt::Connection conn;
+        for (const auto& group : groups()) {
+            if (!members(conn, group, {assetId}).empty()) {
+                auto& line = out.append();
+                line.id    = group.id;
+                line.name  = group.name;
+            }
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+    return std::move(out);
+}
+
+std::string Membership::resolveSql(const commands::Order& order)
+{
+    return R"(
+        SELECT
+            e.id_asset_element as id,
+            e.name
+        FROM t_bios_group_member m
+        JOIN t_bios_asset_element e
+            ON e.id_asset_element = m.asset_id
+        WHERE m.group_id = :id
+    )" + query::page(order);
+}
+
+std::string Membership::countSql()
+{
+    return R"(
+        SELECT
+            COUNT(*) as total
+        FROM t_bios_group_member
+        WHERE group_id = :id
+    )";
+}
+
+} // namespace fty
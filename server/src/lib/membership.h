@@ -0,0 +1,62 @@
+#pragma once
+#include "common/commands.h"
+#include <fty/expected.h>
+
+namespace fty {
+
+/// Group membership, evaluated on group changes and on asset events.
+/// Kept in memory as group->assets and inverted asset->groups index. Optionally (`membership-table` option)
+/// materialized in `t_bios_group_member(group_id, asset_id)` table.
+class Membership
+{
+public:
+    static constexpr const char* AssetCreated = "FTY.T.ASSET.CREATED";
+    static constexpr const char* AssetUpdated = "FTY.T.ASSET.UPDATED";
+    static constexpr const char* AssetDeleted = "FTY.T.ASSET.DELETED";
+
+public:
+    static Membership& instance();
+
+public:
+    Membership();
+    ~Membership();
+
+    /// Returns true if membership of all groups was evaluated
+    static bool ready();
+    /// Returns true if membership table is enabled and filled
+    static bool tableReady();
+
+    /// Creates membership table (if needed) and rebuilds membership of all groups
+    static Expected<void> refresh();
+    /// Refreshes membership of the group
+    static Expected<void> update(const Group& group);
+    /// Removes membership of the group
+    static Expected<void> remove(uint64_t groupId);
+    /// Reevaluates membership of the asset and all assets it contains
+    static Expected<void> assetChanged(const std::string& assetName);
+
+    /// Returns groups which contain the asset
+    static Expected<commands::membership::Out> groupsOf(uint64_t assetId);
+
+    struct Counts
+    {
+        size_t groups  = 0; // groups with evaluated membership
+        size_t members = 0; // asset memberships of all groups
+    };
+
+    static Counts counts();
+
+    /// Grows after every change of membership and every processed asset event
+    static uint64_t version();
+
+    /// Returns sql which selects `id` and `name` of a page of group's assets from membership table, see query::page()
+    static std::string resolveSql(const commands::Order& order);
+    /// Returns sql which selects count of group's assets in membership table as `total`
+    static std::string countSql();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace fty
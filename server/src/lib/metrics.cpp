@@ -0,0 +1,212 @@
+#include "metrics.h"
+#include "common/logger.h"
+#include "executor.h"
+#include "lane.h"
+#include "membership.h"
+#include "request-stats.h"
+#include "single-flight.h"
+#include "storage.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace fty {
+
+// =====================================================================================================================
+
+static std::string label(const std::string& value)
+{
+    std::string ret;
+    for (char ch : value) {
+        if (ch == '\\' || ch == '"') {
+            ret.push_back('\\');
+        } else if (ch == '\n') {
+            ret += "\\n";
+            continue;
+        }
+        ret.push_back(ch);
+    }
+    return ret;
+}
+
+static void header(std::ostream& ss, const char* name, const char* type, const char* help)
+{
+    ss << "# HELP " << name << " " << help << "\n";
+    ss << "# TYPE " << name << " " << type << "\n";
+}
+
+/// Writes histogram as summary in seconds, labels are given without braces
+static void summary(std::ostream& ss, const char* name, const std::string& labels, const Histogram& hist)
+{
+    std::string sep = labels.empty() ? "" : ",";
+    for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+        ss << name << "{" << labels << sep << "quantile=\"" << quantile << "\"} "
+           << double(hist.percentile(quantile * 100)) / 1e6 << "\n";
+    }
+    std::string braced = labels.empty() ? "" : "{" + labels + "}";
+    ss << name << "_sum" << braced << " " << double(hist.sum()) / 1e6 << "\n";
+    ss << name << "_count" << braced << " " << hist.count() << "\n";
+}
+
+// =====================================================================================================================
+
+Metrics::Timer::Timer(Histogram& hist)
+    : m_hist(hist)
+    , m_start(std::chrono::steady_clock::now())
+{
+}
+
+Metrics::Timer::~Timer()
+{
+    m_hist.record(std::chrono::steady_clock::now() - m_start);
+}
+
+// =====================================================================================================================
+
+Metrics& Metrics::instance()
+{
+    static Metrics inst;
+    return inst;
+}
+
+std::string Metrics::render(const std::vector<std::unique_ptr<Lane>>& lanes, const Executor& pool) const
+{
+    std::stringstream ss;
+    auto&             stats = RequestStats::instance();
+
+    header(ss, "agroup_requests_total", "counter", "Requests served, per subject");
+    stats.forEach([&](const std::string& subject, const RequestStats::Timings& timings) {
+        ss << "agroup_requests_total{subject=\"" << label(subject) << "\"} "
+           << timings[RequestStats::Stage::Total].count() << "\n";
+    });
+
+    header(ss, "agroup_request_duration_seconds", "summary", "Time from receiving of a request until its reply");
+    stats.forEach([&](const std::string& subject, const RequestStats::Timings& timings) {
+        summary(ss, "agroup_request_duration_seconds", "subject=\"" + label(subject) + "\"",
+            timings[RequestStats::Stage::Total]);
+    });
+
+    header(ss, "agroup_request_stage_seconds", "summary", "Time of request processing stages");
+    stats.forEach([&](const std::string& subject, const RequestStats::Timings& timings) {
+        for (size_t i = 0; i < size_t(RequestStats::Stage::Total); ++i) {
+            std::stringstream stage;
+            stage << RequestStats::Stage(i);
+            summary(ss, "agroup_request_stage_seconds",
+                "subject=\"" + label(subject) + "\",stage=\"" + stage.str() + "\"", timings.stages[i]);
+        }
+    });
+
+    header(ss, "agroup_lane_queue_depth", "gauge", "Requests queued in a worker lane and not started yet");
+    for (const auto& lane : lanes) {
+        ss << "agroup_lane_queue_depth{lane=\"" << label(lane->name()) << "\"} " << lane->depth() << "\n";
+    }
+
+    header(ss, "agroup_lane_queue_size", "gauge", "Queue limit of a worker lane, 0 is unlimited");
+    for (const auto& lane : lanes) {
+        ss << "agroup_lane_queue_size{lane=\"" << label(lane->name()) << "\"} " << lane->queueSize() << "\n";
+    }
+
+    header(ss, "agroup_lane_rejected_total", "counter", "Requests answered as busy by a worker lane");
+    for (const auto& lane : lanes) {
+        ss << "agroup_lane_rejected_total{lane=\"" << label(lane->name()) << "\"} " << lane->rejected() << "\n";
+    }
+
+    header(ss, "agroup_lane_stolen_total", "counter", "Requests run by other lane worker than they were queued to");
+    for (const auto& lane : lanes) {
+        ss << "agroup_lane_stolen_total{lane=\"" << label(lane->name()) << "\"} " << lane->stolen() << "\n";
+    }
+
+    header(ss, "agroup_pool_queue_depth", "gauge", "Background jobs queued in the pool and not started yet");
+    ss << "agroup_pool_queue_depth " << pool.depth() << "\n";
+    header(ss, "agroup_pool_stolen_total", "counter", "Background jobs run by other worker than they were queued to");
+    ss << "agroup_pool_stolen_total " << pool.stolen() << "\n";
+
+    header(ss, "agroup_storage_lock_wait_seconds", "summary", "Time spent waiting for group storage lock");
+    summary(ss, "agroup_storage_lock_wait_seconds", "", storageLockWait);
+
+    header(ss, "agroup_db_query_seconds", "summary", "Time of database queries");
+    summary(ss, "agroup_db_query_seconds", "", dbQuery);
+
+    auto& flights = SingleFlight::instance();
+    header(ss, "agroup_coalesced_requests_total", "counter",
+        "READ, RESOLVE and READ_MANY requests answered by the reply of identical in-flight request");
+    ss << "agroup_coalesced_requests_total " << flights.hits() << "\n";
+    header(ss, "agroup_coalesce_hit_ratio", "gauge",
+        "Part of READ, RESOLVE and READ_MANY requests answered by identical in-flight request");
+    ss << "agroup_coalesce_hit_ratio " << flights.hitRate() << "\n";
+
+    header(ss, "agroup_groups", "gauge", "Number of groups");
+    ss << "agroup_groups " << Storage::ids().size() << "\n";
+
+    auto counts = Membership::counts();
+    header(ss, "agroup_membership_groups", "gauge", "Number of groups with evaluated membership");
+    ss << "agroup_membership_groups " << counts.groups << "\n";
+    header(ss, "agroup_memberships", "gauge", "Number of asset memberships in all groups");
+    ss << "agroup_memberships " << counts.members << "\n";
+
+    return ss.str();
+}
+
+// =====================================================================================================================
+
+MetricsExporter::MetricsExporter(
+    const std::string& path, std::chrono::seconds interval, std::function<std::string()> render)
+    : m_path(path)
+    , m_interval(interval)
+    , m_render(std::move(render))
+    , m_thread(&MetricsExporter::run, this)
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+void MetricsExporter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+Expected<void> MetricsExporter::write() const
+{
+    std::string tmp = m_path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file) {
+            return unexpected("Cannot open {}", tmp);
+        }
+        file << m_render();
+        if (!file.flush()) {
+            return unexpected("Cannot write {}", tmp);
+        }
+    }
+    if (std::rename(tmp.c_str(), m_path.c_str()) != 0) {
+        return unexpected("Cannot replace {}", m_path);
+    }
+    return {};
+}
+
+void MetricsExporter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        lock.unlock();
+        if (auto res = write(); !res) {
+            logWarn("Automatic group: metrics are not written: {}", res.error());
+        }
+        lock.lock();
+        m_cv.wait_for(lock, m_interval, [&]() {
+            return m_stop;
+        });
+    }
+}
+
+} // namespace fty
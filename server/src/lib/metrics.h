@@ -0,0 +1,70 @@
+#pragma once
+#include "histogram.h"
+#include <chrono>
+#include <condition_variable>
+#include <fty/expected.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fty {
+
+class Executor;
+class Lane;
+
+/// Daemon metrics in Prometheus text format.
+/// Request latencies are taken from RequestStats and coalescing from SingleFlight, the rest is collected here.
+class Metrics
+{
+public:
+    /// Records time spent in the scope
+    class Timer
+    {
+    public:
+        explicit Timer(Histogram& hist);
+        ~Timer();
+
+    private:
+        Histogram&                            m_hist;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+public:
+    static Metrics& instance();
+
+    /// Renders all metrics, lanes and pool give queue depth of the request and background workers
+    std::string render(const std::vector<std::unique_ptr<Lane>>& lanes, const Executor& pool) const;
+
+public:
+    Histogram storageLockWait;
+    Histogram dbQuery;
+};
+
+/// Periodically writes metrics into a file, for example for node_exporter textfile collector.
+/// File is replaced atomically, so scraper never reads partially written one.
+class MetricsExporter
+{
+public:
+    MetricsExporter(const std::string& path, std::chrono::seconds interval, std::function<std::string()> render);
+    ~MetricsExporter();
+
+    Expected<void> write() const;
+    void           stop();
+
+private:
+    void run();
+
+private:
+    std::string                  m_path;
+    std::chrono::seconds         m_interval;
+    std::function<std::string()> m_render;
+    std::mutex                   m_mutex;
+    std::condition_variable      m_cv;
+    bool                         m_stop = false;
+    std::thread                  m_thread;
+};
+
+} // namespace fty
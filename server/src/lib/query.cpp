@@ -0,0 +1,366 @@
+#include "query.h"
+#include "asset-index.h"
+#include "ip-trie.h"
+#include "task.h"
+#include <asset/db.h>
+#include <fty_common_asset_types.h>
+#include <optional>
+
+namespace fty::query {
+
+using job::Error;
+using namespace fmt::literals;
+
+static std::string op(const Group::Condition& cond)
+{
+    switch (cond.op) {
+        case Group::ConditionOp::Contains:
+            return "like";
+        case Group::ConditionOp::Is:
+            return "=";
+        case Group::ConditionOp::IsNot:
+            return "<>";
+    }
+    return "unknown";
+}
+
+static std::string value(const Group::Condition& cond)
+{
+    if (cond.op == Group::ConditionOp::Contains) {
+        return "%{}%"_format(cond.value.value());
+    } else {
+        return cond.value.value();
+    }
+}
+
+static std::string sqlLogicalOperator(const Group::LogicalOp& op)
+{
+    switch (op) {
+        case Group::LogicalOp::And:
+            return "AND";
+        case Group::LogicalOp::Or:
+            return "OR";
+    }
+    return "unknown";
+}
+
+static std::string byName(const Group::Condition& cond)
+{
+    return R"(
+        SELECT
+            id_asset_element
+        FROM
+            t_bios_asset_ext_attributes
+        WHERE
+            keytag='name' AND
+            value {} '{}')"_format(op(cond), value(cond));
+}
+
+static std::string byContact(const Group::Condition& cond)
+{
+    std::string sql = R"(
+        SELECT
+            id_asset_element
+        FROM
+            t_bios_asset_ext_attributes
+        WHERE
+            (keytag='device.contact' OR keytag='contact_email') AND
+            value {op} '{val}')";
+
+    if (cond.op == Group::ConditionOp::IsNot) {
+        sql = R"(
+                SELECT
+                    id_asset_element
+                FROM
+                    t_bios_asset_element
+                WHERE
+                    id_asset_element NOT IN ()" +
+              sql + ")";
+    }
+    return fmt::format(sql, "op"_a = cond.op != Group::ConditionOp::IsNot ? op(cond) : "=", "val"_a = value(cond));
+}
+
+static std::string byType(const Group::Condition& cond)
+{
+    return R"(
+        SELECT
+            e.id_asset_element
+        FROM
+            t_bios_asset_element as e
+        LEFT JOIN t_bios_asset_device_type as t
+            ON e.id_subtype = t.id_asset_device_type
+        WHERE
+            t.name {} '{}')"_format(op(cond), value(cond));
+}
+
+static std::string byLocation(tnt::Connection& conn, const Group::Condition& cond)
+{
+    auto query = R"(
+        SELECT
+            id_asset_element
+        FROM
+            t_bios_asset_element
+        WHERE
+            id_type={} AND
+            name {} '{}')"_format(persist::DATACENTER, op(cond), value(cond));
+
+    try {
+        std::vector<int64_t> ids;
+        // Select all ids for location
+        for (const auto& row : conn.select(query)) {
+            auto elQuery = R"(
+                SELECT
+                    p.id_asset_element
+                FROM
+                    v_bios_asset_element_super_parent p
+                WHERE
+                    :containerid in (p.id_parent1, p.id_parent2, p.id_parent3, p.id_parent4,
+                    p.id_parent5, p.id_parent6, p.id_parent7, p.id_parent8, p.id_parent9, p.id_parent10)
+            )";
+
+            for (const auto& elRow : conn.select(elQuery, "containerid"_p = row.get<int64_t>("id_asset_element"))) {
+                ids.push_back(elRow.get<int64_t>("id_asset_element"));
+            }
+        }
+
+        if (ids.empty()) {
+            return R"(
+                SELECT
+                    id_asset_element
+                FROM
+                    t_bios_asset_element
+                WHERE id_asset_element = 0
+            )";
+        }
+
+        return R"(
+            SELECT
+                id_asset_element
+            FROM
+                t_bios_asset_element
+            WHERE id_asset_element in ({})
+        )"_format(fty::implode(ids, ","));
+    } catch (const std::exception& e) {
+        throw Error(e.what());
+    }
+}
+
+static std::string byHostName(const Group::Condition& cond)
+{
+    std::string sql = R"(
+        SELECT
+            e.id_asset_element
+        FROM
+            t_bios_asset_element e
+        LEFT JOIN
+            t_bios_asset_ext_attributes a ON e.id_asset_element = a.id_asset_element
+        WHERE
+            a.keytag='hostname.1' AND e.id_type = {type} AND
+            a.value {op} '{val}')";
+    if (cond.op == Group::ConditionOp::IsNot) {
+        sql = R"(
+                SELECT
+                    id_asset_element
+                FROM
+                    t_bios_asset_element
+                WHERE
+                     id_type = {type} AND id_asset_element NOT IN ()" +
+              sql + ")";
+    }
+    return fmt::format(sql, "type"_a = persist::DEVICE, "op"_a = cond.op != Group::ConditionOp::IsNot ? op(cond) : "=",
+        "val"_a = value(cond));
+}
+
+static std::string byIpAddress(const Group::Condition& cond)
+{
+    std::string sql = R"(
+        SELECT
+            e.id_asset_element
+        FROM
+            t_bios_asset_element e
+        LEFT JOIN
+            t_bios_asset_ext_attributes a ON e.id_asset_element = a.id_asset_element
+        WHERE
+            a.keytag LIKE 'ip.%' AND e.id_type = {type} AND
+            {val}
+    )";
+
+    if (cond.op == Group::ConditionOp::IsNot) {
+        sql = R"(
+                SELECT
+                    id_asset_element
+                FROM
+                    t_bios_asset_element
+                WHERE
+                     id_type = {type} AND id_asset_element NOT IN ()" +
+              sql + ")";
+    }
+
+    std::vector<std::string> conds;
+    auto                     addresses = fty::split(cond.value, "|");
+    for (const auto& addr : addresses) {
+        if (cond.op != Group::ConditionOp::Contains && addr.find_first_of("/-") != std::string::npos) {
+            auto networks = IpTrie::parse(addr);
+            if (!networks) {
+                throw Error("Wrong ip address '{}' in condition", addr);
+            }
+            for (const auto& network : *networks) {
+                conds.push_back("INET_ATON(a.value) BETWEEN {} AND {}"_format(network.first(), network.last()));
+            }
+        } else if (size_t pos = addr.find("*"); pos != std::string::npos) {
+            std::string pre = addr.substr(0, pos);
+            conds.push_back("a.value LIKE '{}%'"_format(pre));
+        } else {
+            std::string sop = cond.op == Group::ConditionOp::IsNot ? "=" : op(cond);
+            std::string saddr = cond.op == Group::ConditionOp::Contains ? "%" + addr + "%" : addr;
+            conds.push_back(
+                "a.value {} '{}'"_format(sop, saddr));
+        }
+    }
+
+    return fmt::format(sql, "type"_a = persist::DEVICE, "op"_a = cond.op != Group::ConditionOp::IsNot ? op(cond) : "=",
+        "val"_a = fty::implode(conds, " OR "));
+}
+
+/// Ip address conditions are resolved by radix trie over in-memory device addresses instead of chain of `LIKE`
+static std::optional<std::string> byIpIndex(const Group::Condition& cond)
+{
+    auto ids = AssetIndex::ipAddress(cond.value);
+    if (!ids) {
+        return std::nullopt;
+    }
+
+    return R"(
+        SELECT
+            id_asset_element
+        FROM
+            t_bios_asset_element
+        WHERE
+            id_type = {} AND id_asset_element {} ({}))"_format(persist::DEVICE,
+        cond.op == Group::ConditionOp::IsNot ? "NOT IN" : "IN", ids->empty() ? "0" : fty::implode(*ids, ","));
+}
+
+/// Contains conditions on names, host names and contacts and ip address conditions are resolved by in-memory index
+static std::optional<std::string> byIndex(const Group::Condition& cond)
+{
+    if (!AssetIndex::ready()) {
+        return std::nullopt;
+    }
+
+    if (cond.field == Group::Fields::IPAddress) {
+        return cond.op != Group::ConditionOp::Contains ? byIpIndex(cond) : std::nullopt;
+    }
+
+    if (cond.op != Group::ConditionOp::Contains) {
+        return std::nullopt;
+    }
+
+    auto ids = AssetIndex::contains(cond.field, cond.value);
+    if (!ids) {
+        return std::nullopt;
+    }
+
+    std::string sql = R"(
+        SELECT
+            id_asset_element
+        FROM
+            t_bios_asset_element
+        WHERE
+            id_asset_element IN ({}))"_format(ids->empty() ? "0" : fty::implode(*ids, ","));
+
+    if (cond.field == Group::Fields::HostName) {
+        sql += " AND id_type = {}"_format(persist::DEVICE);
+    }
+    return sql;
+}
+
+std::string where(tnt::Connection& conn, const Group::Rules& rules)
+{
+    std::vector<std::string> subQueries;
+    for (const auto& it : rules.conditions) {
+        if (it.is<Group::Condition>()) {
+            const auto& cond = it.get<Group::Condition>();
+            if (auto sql = byIndex(cond)) {
+                subQueries.push_back(*sql);
+                continue;
+            }
+
+            switch (cond.field) {
+                case Group::Fields::Contact:
+                    subQueries.push_back(byContact(cond));
+                    break;
+                case Group::Fields::HostName:
+                    subQueries.push_back(byHostName(cond));
+                    break;
+                case Group::Fields::IPAddress:
+                    subQueries.push_back(byIpAddress(cond));
+                    break;
+                case Group::Fields::Location:
+                    subQueries.push_back(byLocation(conn, cond));
+                    break;
+                case Group::Fields::Name:
+                    subQueries.push_back(byName(cond));
+                    break;
+                case Group::Fields::Type:
+                    subQueries.push_back(byType(cond));
+                    break;
+                case Group::Fields::Unknown:
+                default:
+                    throw Error("Unsupported field '{}' in condition", cond.field.value());
+            }
+        } else {
+            subQueries.push_back(R"(
+                SELECT
+                    id_asset_element
+                FROM t_bios_asset_element
+                WHERE {})"_format(where(conn, it.get<Group::Rules>())));
+        }
+    }
+
+    if (subQueries.empty()) {
+        throw Error("Request is empty");
+    }
+
+    return "(id_asset_element IN ({}))"_format(
+        fty::implode(subQueries, ") " + sqlLogicalOperator(rules.groupOp) + " id_asset_element IN ("));
+}
+
+std::string page(const commands::Order& order)
+{
+    // Same order as commands::Order: items with equal names are ordered by id in the same direction
+    const char* dir = order.descending ? " DESC" : "";
+    if (order.byName) {
+        return "ORDER BY name{0}, id{0} LIMIT :limit OFFSET :offset"_format(dir);
+    }
+    return "ORDER BY id{} LIMIT :limit OFFSET :offset"_format(dir);
+}
+
+std::string resolve(tnt::Connection& conn, const Group::Rules& rules, const commands::Order& order)
+{
+    std::string sql = R"(
+        SELECT
+            id_asset_element as id,
+            name
+        FROM t_bios_asset_element
+        WHERE {}
+        {}
+    )"_format(where(conn, rules), page(order));
+
+    logDebug("resolve query: {}", sql);
+    return sql;
+}
+
+std::string count(tnt::Connection& conn, const Group::Rules& rules)
+{
+    std::string sql = R"(
+        SELECT
+            COUNT(*) as total
+        FROM t_bios_asset_element
+        WHERE {}
+    )"_format(where(conn, rules));
+
+    logDebug("resolve count query: {}", sql);
+    return sql;
+}
+
+} // namespace fty::query
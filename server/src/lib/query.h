@@ -0,0 +1,23 @@
+#pragma once
+#include "common/commands.h"
+#include "common/group.h"
+
+namespace tnt {
+class Connection;
+}
+
+namespace fty::query {
+
+/// Returns sql condition on `id_asset_element` which is true for assets matched by the rules
+std::string where(tnt::Connection& conn, const Group::Rules& rules);
+
+/// Returns `ORDER BY ... LIMIT :limit OFFSET :offset` clause which cuts a page of rows with `id` and `name` columns
+std::string page(const commands::Order& order);
+
+/// Returns sql which selects `id` and `name` of a page of assets matched by the rules, see page()
+std::string resolve(tnt::Connection& conn, const Group::Rules& rules, const commands::Order& order);
+
+/// Returns sql which selects count of all assets matched by the rules as `total`
+std::string count(tnt::Connection& conn, const Group::Rules& rules);
+
+} // namespace fty::query
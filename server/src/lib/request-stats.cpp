@@ -0,0 +1,87 @@
+#include "request-stats.h"
+#include <sstream>
+
+namespace fty {
+
+RequestStats& RequestStats::instance()
+{
+    static RequestStats inst;
+    return inst;
+}
+
+RequestStats::RequestStats()
+{
+    commands::All::forEach([&](auto cmd) {
+        m_subjects.emplace(decltype(cmd)::Subject, std::make_unique<Timings>());
+    });
+}
+
+RequestStats::Timings* RequestStats::timings(const std::string& subject)
+{
+    auto it = m_subjects.find(subject);
+    return it != m_subjects.end() ? it->second.get() : nullptr;
+}
+
+void RequestStats::forEach(const std::function<void(const std::string&, const Timings&)>& func) const
+{
+    for (const auto& [subject, timings] : m_subjects) {
+        func(subject, *timings);
+    }
+}
+
+commands::stats::Out RequestStats::report() const
+{
+    commands::stats::Out out;
+    for (const auto& [subject, timings] : m_subjects) {
+        auto& answer   = out.append();
+        answer.subject = subject;
+
+        for (size_t i = 0; i < size_t(Stage::Count); ++i) {
+            const Histogram& hist = timings->stages[i];
+
+            std::stringstream ss;
+            ss << Stage(i);
+
+            auto& stage = answer.stages.append();
+            stage.name  = ss.str();
+            stage.count = hist.count();
+            stage.min   = hist.min();
+            stage.mean  = uint64_t(hist.mean());
+            stage.p50   = hist.percentile(50);
+            stage.p90   = hist.percentile(90);
+            stage.p99   = hist.percentile(99);
+            stage.p999  = hist.percentile(99.9);
+            stage.max   = hist.max();
+        }
+    }
+    return out;
+}
+
+std::ostream& operator<<(std::ostream& ss, RequestStats::Stage value)
+{
+    switch (value) {
+    case RequestStats::Stage::QueueWait:
+        ss << "queue-wait";
+        break;
+    case RequestStats::Stage::Decode:
+        ss << "decode";
+        break;
+    case RequestStats::Stage::Run:
+        ss << "run";
+        break;
+    case RequestStats::Stage::Serialize:
+        ss << "serialize";
+        break;
+    case RequestStats::Stage::Reply:
+        ss << "reply";
+        break;
+    case RequestStats::Stage::Total:
+        ss << "total";
+        break;
+    case RequestStats::Stage::Count:
+        break;
+    }
+    return ss;
+}
+
+} // namespace fty
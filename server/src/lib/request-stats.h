@@ -0,0 +1,62 @@
+#pragma once
+#include "common/commands.h"
+#include "histogram.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <map>
+
+namespace fty {
+
+/// Latency histograms of request processing, per subject and stage
+class RequestStats
+{
+public:
+    enum class Stage
+    {
+        QueueWait, // from receiving of the request to start of the job
+        Decode,    // payload decoding
+        Run,       // job itself
+        Serialize, // reply encoding
+        Reply,     // sending of the reply
+        Total,     // from receiving of the request until the reply is sent
+        Count
+    };
+
+    struct Timings
+    {
+        Histogram stages[size_t(Stage::Count)];
+
+        Histogram& operator[](Stage stage)
+        {
+            return stages[size_t(stage)];
+        }
+
+        const Histogram& operator[](Stage stage) const
+        {
+            return stages[size_t(stage)];
+        }
+    };
+
+public:
+    static RequestStats& instance();
+
+    /// Timings of the subject, nullptr if the subject is not a known command
+    Timings* timings(const std::string& subject);
+
+    /// Calls `func(subject, timings)` for every subject
+    void forEach(const std::function<void(const std::string&, const Timings&)>& func) const;
+
+    commands::stats::Out report() const;
+
+private:
+    RequestStats();
+
+private:
+    // Filled by constructor for all known commands, so it is never modified later and is read without locking
+    std::map<std::string, std::unique_ptr<Timings>> m_subjects;
+};
+
+std::ostream& operator<<(std::ostream& ss, RequestStats::Stage value);
+
+} // namespace fty
@@ -0,0 +1,150 @@
+#include "search.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SEARCH_X86
+#endif
+
+namespace fty::search {
+
+// =====================================================================================================================
+
+size_t findScalar(std::string_view haystack, std::string_view needle)
+{
+    return haystack.find(needle);
+}
+
+#ifdef SEARCH_X86
+
+/// Compares first and last character of the needle with 32 positions at once, candidates are verified by memcmp
+__attribute__((target("avx2"))) static size_t findAvx2(std::string_view haystack, std::string_view needle)
+{
+    const size_t n = haystack.size();
+    const size_t m = needle.size();
+
+    if (m == 0) {
+        return 0;
+    }
+    if (m > n) {
+        return std::string_view::npos;
+    }
+
+    const char*   hay   = haystack.data();
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last  = _mm256_set1_epi8(needle[m - 1]);
+
+    size_t i = 0;
+    for (; i + m + 31 <= n; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i));
+        __m256i blockLast  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i + m - 1));
+
+        __m256i  eq   = _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(eq));
+
+        while (mask) {
+            size_t pos = i + size_t(__builtin_ctz(mask));
+            if (m <= 2 || memcmp(hay + pos + 1, needle.data() + 1, m - 2) == 0) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    if (auto pos = haystack.substr(i).find(needle); pos != std::string_view::npos) {
+        return i + pos;
+    }
+    return std::string_view::npos;
+}
+
+/// Uses pcmpestri "equal ordered" mode to find candidates in 16 bytes blocks
+__attribute__((target("sse4.2"))) static size_t findSse42(std::string_view haystack, std::string_view needle)
+{
+    const size_t n = haystack.size();
+    const size_t m = needle.size();
+
+    if (m == 0) {
+        return 0;
+    }
+    if (m > n) {
+        return std::string_view::npos;
+    }
+
+    constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ORDERED | _SIDD_LEAST_SIGNIFICANT;
+
+    const char* hay    = haystack.data();
+    const int   prefix = int(m < 16 ? m : 16);
+
+    char buf[16] = {};
+    memcpy(buf, needle.data(), size_t(prefix));
+    const __m128i pattern = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+
+    size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+        int     idx   = _mm_cmpestri(pattern, prefix, block, 16, mode);
+        if (idx == 16) {
+            i += 16;
+            continue;
+        }
+
+        size_t pos = i + size_t(idx);
+        if (pos + m > n) {
+            return std::string_view::npos;
+        }
+        if (memcmp(hay + pos, needle.data(), m) == 0) {
+            return pos;
+        }
+        i = pos + 1;
+    }
+
+    if (auto pos = haystack.substr(i).find(needle); pos != std::string_view::npos) {
+        return i + pos;
+    }
+    return std::string_view::npos;
+}
+
+#endif
+
+// =====================================================================================================================
+
+using FindFunc = size_t (*)(std::string_view, std::string_view);
+
+struct Kernel
+{
+    FindFunc    func;
+    const char* name;
+};
+
+static Kernel detect()
+{
+#ifdef SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {&findAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return {&findSse42, "sse4.2"};
+    }
+#endif
+    return {&findScalar, "scalar"};
+}
+
+static const Kernel& selected()
+{
+    static Kernel kernel = detect();
+    return kernel;
+}
+
+size_t find(std::string_view haystack, std::string_view needle)
+{
+    return selected().func(haystack, needle);
+}
+
+const char* kernel()
+{
+    return selected().name;
+}
+
+} // namespace fty::search
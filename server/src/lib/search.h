@@ -0,0 +1,16 @@
+#pragma once
+#include <string_view>
+
+namespace fty::search {
+
+/// Returns position of the first occurrence of needle in haystack, or npos.
+/// Uses AVX2 or SSE4.2 kernel if supported by cpu, scalar search otherwise.
+size_t find(std::string_view haystack, std::string_view needle);
+
+/// Scalar implementation of find
+size_t findScalar(std::string_view haystack, std::string_view needle);
+
+/// Name of the kernel which is used by find
+const char* kernel();
+
+} // namespace fty::search
@@ -7,16 +7,39 @@
 #include "jobs/remove.h"
 #include "jobs/list.h"
 #include "jobs/read.h"
+#include "jobs/read-many.h"
 #include "jobs/resolve.h"
+#include "jobs/membership.h"
+#include "jobs/membership-of.h"
+#include "jobs/stats.h"
+#include "jobs/version.h"
+#include "membership.h"
+#include "single-flight.h"
 #include <asset/db.h>
 
 namespace fty {
 
+static std::vector<uint32_t> cpus(const pack::UInt32List& list)
+{
+    std::vector<uint32_t> ret;
+    for (const auto& cpu : list) {
+        ret.push_back(cpu);
+    }
+    return ret;
+}
+
+Server::Server()
+    : m_pool(Config::instance().pool.workers.value(), cpus(Config::instance().pool.cpus))
+{
+}
+
 Expected<void> Server::run()
 {
     m_stopSlot.connect(Daemon::instance().stopEvent);
     m_loadConfigSlot.connect(Daemon::instance().loadConfigEvent);
 
+    createLanes();
+
     if (auto res = m_bus.init(Config::instance().actorName); !res) {
         return unexpected(res.error());
     }
@@ -25,6 +48,24 @@ Expected<void> Server::run()
         return unexpected(sub.error());
     }
 
+    EventBatcher::instance().start(m_bus, Config::instance().events.mode.value(),
+        std::chrono::milliseconds(Config::instance().events.window.value()));
+
+    // Membership index is always maintained, see `membership-table` option
+    for (const auto& topic : {Membership::AssetCreated, Membership::AssetUpdated, Membership::AssetDeleted}) {
+        if (auto sub = m_bus.subsribe(topic, &Server::assetEvent, this); !sub) {
+            return unexpected(sub.error());
+        }
+    }
+    m_pool.pushWorker<job::RefreshMembership>();
+
+    if (const auto& path = Config::instance().metricsFile; !path.empty()) {
+        m_metrics = std::make_unique<MetricsExporter>(path.value(),
+            std::chrono::seconds(Config::instance().metricsInterval.value()), [this]() {
+                return Metrics::instance().render(m_lanes, m_pool);
+            });
+    }
+
     return {};
 }
 
@@ -43,27 +84,139 @@ void Server::reloadConfig()
     Config::instance().reload();
 }
 
-void Server::process(const Message& msg)
+void Server::createLanes()
+{
+    auto pinned = cpus(Config::instance().pool.cpus);
+    for (const auto& conf : Config::instance().lanes) {
+        auto lane = std::make_unique<Lane>(conf.name.value(), conf.workers.value(), conf.queueSize.value(),
+            conf.policy.value(), std::chrono::milliseconds(conf.maxWait.value()), pinned);
+        for (const auto& subject : conf.subjects) {
+            m_subjectLanes[subject] = lane.get();
+        }
+        if (conf.name == "default") {
+            m_subjectLanes[""] = lane.get();
+        }
+        m_lanes.push_back(std::move(lane));
+    }
+
+    // Not configured default lane behaves as former thread pool: all cores and unlimited queue
+    if (!m_subjectLanes.count("")) {
+        m_lanes.push_back(std::make_unique<Lane>("default", std::thread::hardware_concurrency(), 0,
+            Lane::Policy::Reject, std::chrono::milliseconds(0), pinned));
+        m_subjectLanes[""] = m_lanes.back().get();
+    }
+}
+
+Lane& Server::lane(const std::string& subject)
+{
+    if (auto it = m_subjectLanes.find(subject); it != m_subjectLanes.end()) {
+        return *it->second;
+    }
+    return *m_subjectLanes[""];
+}
+
+template <typename T>
+void Server::push(Message&& msg)
+{
+    // Identical read request is in flight, it will reply to this one as well
+    if (SingleFlight::coalesced(msg.meta.subject.value()) && SingleFlight::instance().join(msg)) {
+        logDebug("Automatic group: request {} is coalesced, hit rate {:.2f}", msg.meta.subject.value(),
+            SingleFlight::instance().hitRate());
+        return;
+    }
+
+    // Busy reply needs only addressing of the request, payload is moved to the job. Small payload of coalesced
+    // request is kept as it identifies the flight.
+    Message header;
+    header.meta = msg.meta;
+    if (SingleFlight::coalesced(msg.meta.subject.value())) {
+        header.userData = msg.userData;
+    }
+
+    auto busy = [this, header]() {
+        job::Response<void> response;
+        response.setError(BusyError);
+
+        Message answer = response;
+        if (auto res = m_bus.reply(fty::Channel, header, answer); !res) {
+            logError(res.error());
+        }
+        if (SingleFlight::coalesced(header.meta.subject.value())) {
+            for (const auto& follower : SingleFlight::instance().finish(header)) {
+                if (auto res = m_bus.reply(fty::Channel, follower, answer); !res) {
+                    logError(res.error());
+                }
+            }
+        }
+    };
+
+    auto& ln = lane(msg.meta.subject.value());
+    if (ln.pushWorker<T>(busy, std::move(msg), m_bus)) {
+        logDebug("Automatic group: lane {} depth {}", ln.name(), ln.depth());
+        return;
+    }
+
+    logWarn("Automatic group: lane {} is full ({} jobs), request {} is rejected", ln.name(), ln.queueSize(),
+        header.meta.subject.value());
+    busy();
+}
+
+/// Job which serves the command. Request and response types of the job must be the ones of the command.
+template <typename Cmd, typename JobT>
+struct Route : Cmd
+{
+    using Job = JobT;
+
+    static_assert(std::is_same_v<typename Job::Input, typename Cmd::In>, "Job input differs from command request");
+    static_assert(std::is_same_v<typename Job::Output, typename Cmd::Out>, "Job output differs from command response");
+};
+
+// clang-format off
+using Routes = commands::Registry<
+    Route<commands::Create,       job::Create>,
+    Route<commands::Update,       job::Update>,
+    Route<commands::Remove,       job::Remove>,
+    Route<commands::List,         job::List>,
+    Route<commands::Read,         job::Read>,
+    Route<commands::ReadMany,     job::ReadMany>,
+    Route<commands::Resolve,      job::Resolve>,
+    Route<commands::ResolveCount, job::ResolveCount>,
+    Route<commands::Membership,   job::MembershipOf>,
+    Route<commands::Stats,        job::Stats>,
+    Route<commands::Version,      job::Version>>;
+// clang-format on
+
+void Server::process(Message msg)
 {
     logDebug("Automatic group: got message {}, payload:\n   {}", msg.meta.subject.value(), msg.userData.asString());
-    if (msg.meta.subject == commands::create::Subject) {
-        m_pool.pushWorker<job::Create>(msg, m_bus);
-    } else if (msg.meta.subject == commands::update::Subject) {
-        m_pool.pushWorker<job::Update>(msg, m_bus);
-    } else if (msg.meta.subject == commands::remove::Subject) {
-        m_pool.pushWorker<job::Remove>(msg, m_bus);
-    } else if (msg.meta.subject == commands::list::Subject) {
-        m_pool.pushWorker<job::List>(msg, m_bus);
-    } else if (msg.meta.subject == commands::read::Subject) {
-        m_pool.pushWorker<job::Read>(msg, m_bus);
-    } else if (msg.meta.subject == commands::resolve::Subject) {
-        m_pool.pushWorker<job::Resolve>(msg, m_bus);
+
+    const std::string subject = msg.meta.subject.value();
+    bool              known   = Routes::dispatch(subject, [&](auto route) {
+        push<typename decltype(route)::Job>(std::move(msg));
+    });
+
+    if (!known) {
+        logWarn("Automatic group: unknown request {}", subject);
     }
 }
 
+void Server::assetEvent(const Message& msg)
+{
+    logDebug("Automatic group: got asset event {}", msg.meta.subject.value());
+    m_pool.pushWorker<job::AssetChanged>(msg);
+}
+
 void Server::shutdown()
 {
     stop();
+    if (m_metrics) {
+        m_metrics->stop();
+    }
+    for (auto& ln : m_lanes) {
+        ln->stop();
+    }
+    // Jobs are finished, so their notifications could be published
+    EventBatcher::instance().stop();
     m_pool.stop();
 }
 
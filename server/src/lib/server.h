@@ -1,27 +1,44 @@
 #pragma once
 #include "common/message-bus.h"
+#include "executor.h"
+#include "lane.h"
+#include "metrics.h"
 #include <fty/event.h>
-#include <fty/thread-pool.h>
+#include <unordered_map>
 
 namespace fty {
 
 class Server
 {
 public:
+    Server();
+
     [[nodiscard]] Expected<void> run();
     void                         shutdown();
     void                         wait();
 
+    /// Lane which serves the subject
+    Lane& lane(const std::string& subject);
+
     Event<> stop;
 
 private:
-    void process(const Message& msg);
+    void process(Message msg);
+    void assetEvent(const Message& msg);
     void doStop();
     void reloadConfig();
+    void createLanes();
+
+    template <typename T>
+    void push(Message&& msg);
 
 private:
     MessageBus m_bus;
-    ThreadPool m_pool;
+    Executor   m_pool;
+
+    std::vector<std::unique_ptr<Lane>>     m_lanes;
+    std::unordered_map<std::string, Lane*> m_subjectLanes;
+    std::unique_ptr<MetricsExporter>       m_metrics;
 
     Slot<> m_stopSlot       = {&Server::doStop, this};
     Slot<> m_loadConfigSlot = {&Server::reloadConfig, this};
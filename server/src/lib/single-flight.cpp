@@ -0,0 +1,71 @@
+#include "single-flight.h"
+#include "common/commands.h"
+
+namespace fty {
+
+SingleFlight& SingleFlight::instance()
+{
+    static SingleFlight inst;
+    return inst;
+}
+
+bool SingleFlight::coalesced(const std::string& subject)
+{
+    return subject == commands::read::Subject || subject == commands::resolve::Subject ||
+           subject == commands::readMany::Subject;
+}
+
+std::string SingleFlight::key(const Message& msg)
+{
+    // Same payload could be decoded differently and the reply is encoded as the request, so encoding is a part of key
+    return msg.meta.subject.value() + '\n' + std::to_string(int(msg.meta.encoding.value())) + '\n' +
+           msg.userData.asString();
+}
+
+bool SingleFlight::join(const Message& msg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto [it, inserted] = m_flights.try_emplace(key(msg));
+    if (inserted) {
+        ++m_misses;
+        return false;
+    }
+
+    it->second.push_back(msg);
+    ++m_hits;
+    return true;
+}
+
+std::vector<Message> SingleFlight::finish(const Message& msg)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_flights.find(key(msg));
+    if (it == m_flights.end()) {
+        return {};
+    }
+
+    auto followers = std::move(it->second);
+    m_flights.erase(it);
+    return followers;
+}
+
+uint64_t SingleFlight::hits() const
+{
+    return m_hits;
+}
+
+uint64_t SingleFlight::misses() const
+{
+    return m_misses;
+}
+
+double SingleFlight::hitRate() const
+{
+    uint64_t hits  = m_hits;
+    uint64_t total = hits + m_misses;
+    return total ? double(hits) / double(total) : 0.;
+}
+
+} // namespace fty
@@ -0,0 +1,45 @@
+#pragma once
+#include "common/message.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+/// Coalescing of identical concurrent requests.
+/// First request with given subject, payload and its encoding is the leader and is run, identical requests which come
+/// while the leader is running are followers: they are not run, but get the reply of the leader.
+class SingleFlight
+{
+public:
+    static SingleFlight& instance();
+
+    /// Returns true if requests of the subject could be coalesced: they only read
+    static bool coalesced(const std::string& subject);
+
+    /// Registers the request. Returns true if the request is a follower, i.e. identical request is in flight already.
+    bool join(const Message& msg);
+
+    /// Finishes the flight of the leader request, returns followers which should get the same reply
+    std::vector<Message> finish(const Message& msg);
+
+    /// Number of requests which were served by another in-flight request
+    uint64_t hits() const;
+    /// Number of requests which were run
+    uint64_t misses() const;
+    /// hits / (hits + misses)
+    double hitRate() const;
+
+private:
+    static std::string key(const Message& msg);
+
+private:
+    std::mutex                                             m_mutex;
+    std::unordered_map<std::string, std::vector<Message>> m_flights;
+    std::atomic<uint64_t>                                  m_hits   = 0;
+    std::atomic<uint64_t>                                  m_misses = 0;
+};
+
+} // namespace fty
@@ -1,8 +1,11 @@
 #include "storage.h"
 #include "config.h"
+#include "metrics.h"
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <filesystem>
+#include <unordered_map>
 
 namespace fty {
 
@@ -50,9 +53,17 @@ public:
         return {};
     }
 
+    /// Locks the storage, time of waiting for the lock is recorded in metrics
+    std::unique_lock<std::mutex> lock()
+    {
+        Metrics::Timer timer(Metrics::instance().storageLockWait);
+        return std::unique_lock<std::mutex>(mutex);
+    }
+
 public:
-    std::mutex mutex;
-    DbObj      db;
+    std::mutex            mutex;
+    DbObj                 db;
+    std::atomic<uint64_t> version = 0;
 
 private:
     std::string m_dbpath;
@@ -76,8 +87,8 @@ Storage::~Storage()
 
 Expected<Group> Storage::byName(const std::string& name)
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -96,8 +107,8 @@ Expected<Group> Storage::byName(const std::string& name)
 
 Expected<Group> Storage::byId(uint64_t id)
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -116,8 +127,8 @@ Expected<Group> Storage::byId(uint64_t id)
 
 std::vector<std::string> Storage::names()
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -134,8 +145,8 @@ std::vector<std::string> Storage::names()
 
 std::vector<uint64_t> Storage::ids()
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -150,10 +161,58 @@ std::vector<uint64_t> Storage::ids()
     return ret;
 }
 
+std::vector<Group> Storage::all()
+{
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
+
+    if (!db.m_impl->inited()) {
+        db.m_impl->init();
+    }
+
+    std::vector<Group> ret;
+    ret.reserve(db.m_impl->db.groups.size());
+    for (const auto& group : db.m_impl->db.groups) {
+        ret.push_back(group);
+    }
+
+    return ret;
+}
+
+std::vector<Group> Storage::byIds(const std::vector<uint64_t>& ids)
+{
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
+
+    if (!db.m_impl->inited()) {
+        db.m_impl->init();
+    }
+
+    std::unordered_map<uint64_t, const Group*> index;
+    for (const auto& group : db.m_impl->db.groups) {
+        index.emplace(group.id.value(), &group);
+    }
+
+    std::vector<Group> ret;
+    ret.reserve(ids.size());
+    for (const auto& id : ids) {
+        if (auto it = index.find(id); it != index.end()) {
+            ret.push_back(*it->second);
+        }
+    }
+
+    return ret;
+}
+
+uint64_t Storage::version()
+{
+    return instance().m_impl->version;
+}
+
 Expected<Group> Storage::save(const Group& group)
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -177,14 +236,15 @@ Expected<Group> Storage::save(const Group& group)
     if (auto ret = db.m_impl->save(); !ret) {
         return unexpected(ret.error());
     }
+    ++db.m_impl->version;
 
     return std::move(toSave);
 }
 
 Expected<void> Storage::removeByName(const std::string& groupName)
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -197,14 +257,15 @@ Expected<void> Storage::removeByName(const std::string& groupName)
     if (auto ret = db.m_impl->save(); !ret) {
         return unexpected(ret.error());
     }
+    ++db.m_impl->version;
 
     return {};
 }
 
 Expected<void> Storage::remove(uint64_t id)
 {
-    auto&                       db = instance();
-    std::lock_guard<std::mutex> guard(db.m_impl->mutex);
+    auto& db    = instance();
+    auto  guard = db.m_impl->lock();
 
     if (!db.m_impl->inited()) {
         db.m_impl->init();
@@ -218,6 +279,7 @@ Expected<void> Storage::remove(uint64_t id)
         if (auto ret = db.m_impl->save(); !ret) {
             return unexpected(ret.error());
         }
+        ++db.m_impl->version;
     } else {
         return unexpected("Id '{}' was not found", id);
     }
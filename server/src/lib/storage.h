@@ -17,6 +17,13 @@ public:
     static Expected<Group>          byId(uint64_t id);
     static std::vector<std::string> names();
     static std::vector<uint64_t>    ids();
+    /// All groups, read under one lock
+    static std::vector<Group>       all();
+    /// Groups with the ids, unknown ids are skipped
+    static std::vector<Group>       byIds(const std::vector<uint64_t>& ids);
+
+    /// Grows after every change of groups
+    static uint64_t version();
 
     static Expected<Group> save(const Group& group);
     static Expected<void>  remove(uint64_t id);
@@ -0,0 +1,157 @@
+#include "string-column.h"
+#include "search.h"
+#include <algorithm>
+#include <iterator>
+
+namespace fty {
+
+void StringColumn::add(uint64_t id, std::string_view value)
+{
+    uint32_t row = uint32_t(m_offsets.size());
+
+    m_offsets.push_back(uint32_t(m_data.size()));
+    m_ids.push_back(id);
+    m_rows.emplace(id, row);
+
+    for (char ch : value) {
+        m_data.push_back((ch >= 'A' && ch <= 'Z') ? char(ch - 'A' + 'a') : ch);
+    }
+    m_data.push_back('\0');
+
+    // Rows are only appended, so posting lists stay sorted
+    std::string_view lowered = this->value(row);
+    for (size_t pos = 0; pos + 3 <= lowered.size(); ++pos) {
+        auto& rows = m_trigrams[trigram(lowered, pos)];
+        if (rows.empty() || rows.back() != row) {
+            rows.push_back(row);
+        }
+    }
+}
+
+void StringColumn::remove(uint64_t id)
+{
+    auto range = m_rows.equal_range(id);
+    for (auto it = range.first; it != range.second; ++it) {
+        m_ids[it->second] = 0;
+        m_garbage += value(it->second).size() + 1;
+    }
+    m_rows.erase(id);
+
+    if (m_garbage > m_data.size() / 2) {
+        compact();
+    }
+}
+
+void StringColumn::clear()
+{
+    m_data.clear();
+    m_offsets.clear();
+    m_ids.clear();
+    m_rows.clear();
+    m_trigrams.clear();
+    m_garbage = 0;
+}
+
+std::vector<uint64_t> StringColumn::contains(std::string_view needle) const
+{
+    if (needle.size() >= 3) {
+        return lookup(needle);
+    }
+    return scan(needle);
+}
+
+std::vector<uint64_t> StringColumn::scan(std::string_view needle) const
+{
+    std::vector<uint64_t> ret;
+
+    std::string_view data(m_data);
+    size_t           from = 0;
+    while (from < data.size()) {
+        size_t pos = search::find(data.substr(from), needle);
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        pos += from;
+
+        // Values are separated by '\0', so match is always inside of one row
+        auto   it  = std::upper_bound(m_offsets.begin(), m_offsets.end(), uint32_t(pos));
+        size_t row = size_t(it - m_offsets.begin()) - 1;
+        if (m_ids[row]) {
+            ret.push_back(m_ids[row]);
+        }
+        from = row + 1 < m_offsets.size() ? m_offsets[row + 1] : data.size();
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+std::string_view StringColumn::value(uint32_t row) const
+{
+    size_t begin = m_offsets[row];
+    size_t end   = row + 1 < m_offsets.size() ? m_offsets[row + 1] : m_data.size();
+    return std::string_view(m_data).substr(begin, end - begin - 1);
+}
+
+std::vector<uint64_t> StringColumn::lookup(std::string_view needle) const
+{
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t pos = 0; pos + 3 <= needle.size(); ++pos) {
+        auto it = m_trigrams.find(trigram(needle, pos));
+        if (it == m_trigrams.end()) {
+            return {};
+        }
+        lists.push_back(&it->second);
+    }
+
+    // Intersect starting from the shortest list, so candidates only shrink
+    std::sort(lists.begin(), lists.end(), [](const auto* l, const auto* r) {
+        return l->size() < r->size();
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    std::vector<uint32_t> candidates = *lists.front();
+    std::vector<uint32_t> next;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        next.clear();
+        std::set_intersection(
+            candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(next));
+        candidates.swap(next);
+    }
+
+    // Trigrams could be found in different places of the value, so check the candidates
+    std::vector<uint64_t> ret;
+    for (uint32_t row : candidates) {
+        if (m_ids[row] && value(row).find(needle) != std::string_view::npos) {
+            ret.push_back(m_ids[row]);
+        }
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+uint32_t StringColumn::trigram(std::string_view str, size_t pos)
+{
+    return uint32_t(uint8_t(str[pos])) << 16 | uint32_t(uint8_t(str[pos + 1])) << 8 | uint32_t(uint8_t(str[pos + 2]));
+}
+
+size_t StringColumn::size() const
+{
+    return m_rows.size();
+}
+
+void StringColumn::compact()
+{
+    StringColumn compacted;
+    for (uint32_t row = 0; row < m_offsets.size(); ++row) {
+        if (m_ids[row]) {
+            compacted.add(m_ids[row], value(row));
+        }
+    }
+    *this = std::move(compacted);
+}
+
+} // namespace fty
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fty {
+
+/// Contiguous in-memory column of lower-cased string values, each row belongs to some asset id.
+/// Values are stored in one buffer separated by '\0', so the whole column is scanned by one substring search.
+/// Every row is also indexed by its trigrams, so needles of three and more characters are answered by intersection of
+/// posting lists and verification of the candidate rows.
+class StringColumn
+{
+public:
+    void add(uint64_t id, std::string_view value);
+    void remove(uint64_t id);
+    void clear();
+
+    /// Returns sorted ids of the rows which contain lower-cased needle
+    std::vector<uint64_t> contains(std::string_view needle) const;
+    /// Same as contains, but always scans the whole column
+    std::vector<uint64_t> scan(std::string_view needle) const;
+
+    /// Returns value of the row
+    std::string_view value(uint32_t row) const;
+
+    size_t size() const;
+
+private:
+    void                  compact();
+    std::vector<uint64_t> lookup(std::string_view needle) const;
+
+    static uint32_t trigram(std::string_view str, size_t pos);
+
+private:
+    std::string                                          m_data;
+    std::vector<uint32_t>                                m_offsets;
+    std::vector<uint64_t>                                m_ids;
+    std::unordered_multimap<uint64_t, uint32_t>          m_rows;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+    size_t                                               m_garbage = 0;
+};
+
+} // namespace fty
@@ -4,6 +4,9 @@
 #include "common/message-bus.h"
 #include "common/message.h"
 #include "config.h"
+#include "event-batcher.h"
+#include "request-stats.h"
+#include "single-flight.h"
 #include <fty/expected.h>
 #include <fty/thread-pool.h>
 
@@ -57,6 +60,12 @@ public:
     }
 
     operator Message()
+    {
+        return message(Message::Encoding::Json);
+    }
+
+    /// Builds reply message with payload in requested encoding
+    Message message(Message::Encoding encoding)
     {
         Message msg;
         msg.meta.status = status;
@@ -65,7 +74,12 @@ public:
         }
 
         if (status == Message::Status::Ok) {
-            if (out.hasValue()) {
+            if (encoding == Message::Encoding::Binary) {
+                if (auto res = msg.encode(out, encoding); !res) {
+                    msg.meta.status = Message::Status::Error;
+                    msg.userData.setString(res.error());
+                }
+            } else if (out.hasValue()) {
                 msg.userData.setString(*pack::json::serialize(out));
             } else {
                 if constexpr (std::is_base_of_v<pack::IList, T>) {
@@ -102,6 +116,11 @@ public:
     }
 
     operator Message()
+    {
+        return message(Message::Encoding::Json);
+    }
+
+    Message message(Message::Encoding /*encoding*/)
     {
         Message msg;
         msg.meta.status = status;
@@ -117,70 +136,121 @@ public:
 template <typename T, typename InputT, typename ResponseT = void>
 class Task : public fty::Task<T>
 {
+public:
+    using Input  = InputT;
+    using Output = ResponseT;
+
 public:
     Task(const Message& in, MessageBus& bus)
         : m_in(in)
         , m_bus(&bus)
+        , m_timings(RequestStats::instance().timings(m_in.meta.subject.value()))
+    {
+    }
+
+    Task(Message&& in, MessageBus& bus)
+        : m_in(std::move(in))
+        , m_bus(&bus)
+        , m_timings(RequestStats::instance().timings(m_in.meta.subject.value()))
     {
     }
 
     void operator()() override
     {
+        static_assert(std::is_base_of_v<Task, T>, "Job must derive from its task");
+
+        T&                  job = static_cast<T&>(*this);
         Response<ResponseT> response;
+
+        auto mark = std::chrono::steady_clock::now();
+        record(RequestStats::Stage::QueueWait, m_queued, mark);
         try {
-            if (auto it = dynamic_cast<T*>(this)) {
-                if constexpr (!std::is_same<InputT, void>::value) {
-                    if (m_in.userData.empty()) {
-                        throw Error("Wrong input data: payload is empty");
-                    }
-
-                    InputT cmd;
-                    if (auto parsedCmd = m_in.userData.decode<InputT>()) {
-                        cmd = *parsedCmd;
-                    } else {
-                        throw Error("Wrong input data: format of payload is incorrect");
-                    }
-
-                    if constexpr (std::is_same<ResponseT, void>::value) {
-                        it->run(cmd);
-                    } else {
-                        it->run(cmd, response.out);
-                    }
-                } else if constexpr (!std::is_same<ResponseT, void>::value) {
-                    it->run(response.out);
+            if constexpr (!std::is_same<InputT, void>::value) {
+                if (m_in.userData.empty()) {
+                    throw Error("Wrong input data: payload is empty");
                 }
-            } else {
-                throw Error("Not a correct task");
+
+                InputT cmd;
+                if (auto parsedCmd = m_in.decode<InputT>()) {
+                    cmd = std::move(*parsedCmd);
+                } else {
+                    throw Error("Wrong input data: format of payload is incorrect");
+                }
+                mark = record(RequestStats::Stage::Decode, mark);
+
+                if constexpr (std::is_same<ResponseT, void>::value) {
+                    job.run(cmd);
+                } else {
+                    job.run(cmd, response.out);
+                }
+            } else if constexpr (!std::is_same<ResponseT, void>::value) {
+                job.run(response.out);
             }
+            record(RequestStats::Stage::Run, mark);
 
             response.status = Message::Status::Ok;
-            if (auto res = m_bus->reply(fty::Channel, m_in, response); !res) {
-                logError(res.error());
-            }
+            reply(response);
         } catch (const Error& err) {
             logError("Error: {}", err.what());
             response.setError(err.what());
-            if (auto res = m_bus->reply(fty::Channel, m_in, response); !res) {
-                logError(res.error());
-            }
+            reply(response);
+        } catch (const std::exception& err) {
+            // Any request must be replied, otherwise coalesced followers would wait for the leader forever
+            logError("Unexpected error: {}", err.what());
+            response.setError(err.what());
+            reply(response);
         }
     }
 
-    template <typename Payload>
-    void notify(const std::string& subject, const Payload& payload)
+    /// Notifies subscribers about change of the group, see EventBatcher
+    void notify(const std::string& event, uint64_t id)
     {
-        Response<Payload> msg;
-        msg.subject = subject;
-        msg.out     = payload;
+        EventBatcher::instance().notify(event, id);
+    }
 
-        if (auto ret = m_bus->publish(fty::Events, msg); !ret) {
-            logError(ret.error());
+private:
+    /// Replies to the request and to identical requests which were coalesced with it
+    void reply(Response<ResponseT>& response)
+    {
+        // Reply is encoded the same way as the request
+        auto    mark   = std::chrono::steady_clock::now();
+        Message answer = response.message(m_in.meta.encoding.value());
+        mark           = record(RequestStats::Stage::Serialize, mark);
+
+        if (SingleFlight::coalesced(m_in.meta.subject.value())) {
+            for (const auto& follower : SingleFlight::instance().finish(m_in)) {
+                if (auto res = m_bus->reply(fty::Channel, follower, answer); !res) {
+                    logError(res.error());
+                }
+            }
+        }
+
+        // Followers got their copies, the payload is moved into the last reply
+        if (auto res = m_bus->reply(fty::Channel, m_in, std::move(answer)); !res) {
+            logError(res.error());
         }
+        mark = record(RequestStats::Stage::Reply, mark);
+        record(RequestStats::Stage::Total, m_queued, mark);
+    }
+
+    /// Records time of the stage which lasted from `start` until `end`, returns `end`
+    std::chrono::steady_clock::time_point record(RequestStats::Stage stage,
+        std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now())
+    {
+        if (m_timings) {
+            (*m_timings)[stage].record(end - start);
+        }
+        return end;
     }
 
 protected:
     Message     m_in;
     MessageBus* m_bus;
+
+private:
+    RequestStats::Timings*                m_timings;
+    std::chrono::steady_clock::time_point m_queued = std::chrono::steady_clock::now();
 };
 
 } // namespace fty::job
@@ -0,0 +1,46 @@
+#include "common/commands.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Command registry")
+{
+    using namespace fty::commands;
+
+    for (const char* subject :
+         {"CREATE", "UPDATE", "DELETE", "RESOLVE", "RESOLVE_COUNT", "LIST", "READ", "MEMBERSHIP_OF"}) {
+        std::string dispatched;
+        CHECK(All::dispatch(subject, [&](auto cmd) {
+            dispatched = decltype(cmd)::Subject;
+        }));
+        CHECK(dispatched == subject);
+    }
+
+    CHECK(!All::dispatch("", [](auto) {}));
+    CHECK(!All::dispatch("read", [](auto) {}));
+    CHECK(!All::dispatch("CREATED", [](auto) {}));
+
+    STATIC_REQUIRE(All::Key<Read> == hash("READ"));
+    STATIC_REQUIRE(std::is_same_v<Resolve::Out, resolve::Out>);
+    STATIC_REQUIRE(std::is_same_v<List::In, void>);
+}
+
+TEST_CASE("Command order")
+{
+    using fty::commands::Order;
+
+    CHECK(Order::parse(""));
+    CHECK(Order::parse("-id"));
+    CHECK(!Order::parse("size"));
+    CHECK(!Order::parse("-"));
+
+    auto byId = *Order::parse("id");
+    CHECK(byId(1, "b", 2, "a"));
+    CHECK(!byId(2, "a", 1, "b"));
+
+    auto byName = *Order::parse("name");
+    CHECK(byName(2, "a", 1, "b"));
+    CHECK(byName(1, "a", 2, "a"));
+
+    auto byNameDesc = *Order::parse("-name");
+    CHECK(byNameDesc(1, "b", 2, "a"));
+    CHECK(byNameDesc(2, "a", 1, "a"));
+}
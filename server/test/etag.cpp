@@ -0,0 +1,48 @@
+#include "common/etag.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("ETag")
+{
+    SECTION("Weak")
+    {
+        CHECK(fty::etag::weak(R"("1-2-3")") == R"(W/"1-2-3")");
+        CHECK(fty::etag::weak("").empty());
+    }
+
+    SECTION("Match")
+    {
+        CHECK(fty::etag::matches(R"("1-2")", R"("1-2")"));
+        CHECK(!fty::etag::matches(R"("1-3")", R"("1-2")"));
+        CHECK(!fty::etag::matches("", R"("1-2")"));
+    }
+
+    SECTION("List")
+    {
+        CHECK(fty::etag::matches(R"("0-1", "1-2")", R"("1-2")"));
+        CHECK(fty::etag::matches(R"("1-2",)", R"("1-2")"));
+        CHECK(!fty::etag::matches(R"("0-1", "1-3")", R"("1-2")"));
+    }
+
+    SECTION("Weak comparison")
+    {
+        CHECK(fty::etag::matches(R"(W/"1-2-3")", R"(W/"1-2-3")"));
+        CHECK(fty::etag::matches(R"("1-2-3")", R"(W/"1-2-3")"));
+        CHECK(fty::etag::matches(R"(W/"1-2")", R"("1-2")"));
+        CHECK(!fty::etag::matches(R"(W/"1-2-4")", R"(W/"1-2-3")"));
+    }
+
+    SECTION("Any")
+    {
+        CHECK(fty::etag::matches("*", R"("1-2")"));
+        CHECK(fty::etag::matches(R"("0-1", *)", R"(W/"1-2-3")"));
+    }
+
+    SECTION("Empty tag")
+    {
+        // Untagged answer is always sent
+        CHECK(!fty::etag::matches("*", ""));
+        CHECK(!fty::etag::matches(R"("")", ""));
+        CHECK(!fty::etag::matches("", ""));
+        CHECK(!fty::etag::matches("W/", "W/"));
+    }
+}
@@ -0,0 +1,143 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "lib/evaluator.h"
+#include <catch2/catch.hpp>
+
+static fty::Group::Condition& condition(
+    fty::Group::Rules& rules, fty::Group::Fields field, fty::Group::ConditionOp op, const std::string& value)
+{
+    auto& var  = rules.conditions.append();
+    auto& cond = var.reset<fty::Group::Condition>();
+    cond.field = field;
+    cond.op    = op;
+    cond.value = value;
+    return cond;
+}
+
+static fty::AssetRecord server(const std::string& name, const std::string& ip, const std::string& location)
+{
+    fty::AssetRecord rec;
+    rec.device = true;
+    rec.name   = name;
+    rec.type   = "server";
+    rec.ips.push_back(ip);
+    rec.locations.push_back(location);
+    return rec;
+}
+
+TEST_CASE("Evaluator")
+{
+    SECTION("empty")
+    {
+        fty::Group::Rules rules;
+        CHECK(!fty::Evaluator::compile(rules));
+    }
+
+    SECTION("name")
+    {
+        fty::Group::Rules rules;
+        rules.groupOp = fty::Group::LogicalOp::And;
+        auto& cond    = condition(rules, fty::Group::Fields::Name, fty::Group::ConditionOp::Contains, "SRV");
+
+        auto eval = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(eval->match(server("srv1", "127.0.0.1", "dc")));
+        CHECK(!eval->match(server("ups", "127.0.0.1", "dc")));
+
+        cond.op    = fty::Group::ConditionOp::IsNot;
+        cond.value = "srv1";
+        eval       = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(!eval->match(server("srv1", "127.0.0.1", "dc")));
+        CHECK(eval->match(server("srv2", "127.0.0.1", "dc")));
+    }
+
+    SECTION("ip address")
+    {
+        fty::Group::Rules rules;
+        rules.groupOp = fty::Group::LogicalOp::And;
+        condition(rules, fty::Group::Fields::IPAddress, fty::Group::ConditionOp::Is, "127.0.*|192.168.0.1");
+
+        auto eval = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(eval->match(server("srv1", "127.0.0.1", "dc")));
+        CHECK(eval->match(server("srv2", "192.168.0.1", "dc")));
+        CHECK(!eval->match(server("srv3", "192.168.0.10", "dc")));
+
+        auto notDevice   = server("srv1", "127.0.0.1", "dc");
+        notDevice.device = false;
+        CHECK(!eval->match(notDevice));
+    }
+
+    SECTION("ip network")
+    {
+        fty::Group::Rules rules;
+        rules.groupOp = fty::Group::LogicalOp::And;
+        auto& cond    = condition(
+            rules, fty::Group::Fields::IPAddress, fty::Group::ConditionOp::Is, "10.0.0.0/8|192.168.0.5-192.168.0.9");
+
+        auto eval = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(eval->match(server("srv1", "10.20.30.40", "dc")));
+        CHECK(eval->match(server("srv2", "192.168.0.7", "dc")));
+        CHECK(!eval->match(server("srv3", "192.168.0.10", "dc")));
+        CHECK(!eval->match(server("srv4", "fe80::1", "dc")));
+
+        cond.op = fty::Group::ConditionOp::IsNot;
+        eval    = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(!eval->match(server("srv1", "10.20.30.40", "dc")));
+        CHECK(eval->match(server("srv3", "192.168.0.10", "dc")));
+    }
+
+    SECTION("nested")
+    {
+        fty::Group::Rules rules;
+        rules.groupOp = fty::Group::LogicalOp::And;
+        condition(rules, fty::Group::Fields::Location, fty::Group::ConditionOp::Is, "datacenter");
+
+        auto& var      = rules.conditions.append();
+        auto& nested   = var.reset<fty::Group::Rules>();
+        nested.groupOp = fty::Group::LogicalOp::Or;
+        condition(nested, fty::Group::Fields::Name, fty::Group::ConditionOp::Is, "srv1");
+        condition(nested, fty::Group::Fields::Name, fty::Group::ConditionOp::Is, "srv2");
+
+        auto eval = fty::Evaluator::compile(rules);
+        REQUIRE(eval);
+        CHECK(eval->match(server("srv1", "127.0.0.1", "DataCenter")));
+        CHECK(eval->match(server("srv2", "127.0.0.1", "datacenter")));
+        CHECK(!eval->match(server("srv3", "127.0.0.1", "datacenter")));
+        CHECK(!eval->match(server("srv1", "127.0.0.1", "datacenter1")));
+    }
+}
+
+TEST_CASE("Evaluator benchmark", "[.][benchmark]")
+{
+    fty::Group::Rules rules;
+    rules.groupOp = fty::Group::LogicalOp::And;
+    condition(rules, fty::Group::Fields::Name, fty::Group::ConditionOp::Contains, "srv-1");
+    condition(rules, fty::Group::Fields::IPAddress, fty::Group::ConditionOp::Is, "10.0.*|10.2.*|192.168.0.1");
+
+    auto& var      = rules.conditions.append();
+    auto& nested   = var.reset<fty::Group::Rules>();
+    nested.groupOp = fty::Group::LogicalOp::Or;
+    condition(nested, fty::Group::Fields::Location, fty::Group::ConditionOp::Is, "datacenter-3");
+    condition(nested, fty::Group::Fields::Type, fty::Group::ConditionOp::IsNot, "ups");
+
+    auto eval = fty::Evaluator::compile(rules);
+    REQUIRE(eval);
+
+    std::vector<fty::AssetRecord> assets;
+    for (int i = 0; i < 10000; ++i) {
+        std::string ip = "10." + std::to_string(i % 4) + ".0." + std::to_string(i % 250);
+        assets.push_back(server("srv-" + std::to_string(i), ip, "datacenter-" + std::to_string(i % 8)));
+    }
+
+    BENCHMARK("match 10000 assets")
+    {
+        size_t matched = 0;
+        for (const auto& asset : assets) {
+            matched += eval->match(asset);
+        }
+        return matched;
+    };
+}
@@ -0,0 +1,112 @@
+#include "lib/config.h"
+#include "lib/event-batcher.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <sstream>
+
+static std::vector<uint64_t> ids(const pack::UInt64List& list)
+{
+    std::vector<uint64_t> ret;
+    for (const auto& id : list) {
+        ret.push_back(id);
+    }
+    return ret;
+}
+
+TEST_CASE("Event batch")
+{
+    using namespace fty::commands::notify;
+
+    fty::EventBatch batch;
+    CHECK(batch.empty());
+
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        batch.add(Deleted, id);
+    }
+    batch.add(Created, 2000);
+    batch.add(Updated, 2000);
+    batch.add(Updated, 3000);
+    batch.add(Updated, 3000);
+    batch.add(Created, 4000);
+    batch.add(Deleted, 4000);
+    batch.add(Updated, 5000);
+    batch.add(Deleted, 5000);
+    CHECK(!batch.empty());
+
+    auto payload = batch.payload();
+    CHECK(ids(payload.created) == std::vector<uint64_t>{2000});
+    CHECK(ids(payload.updated) == std::vector<uint64_t>{3000});
+    CHECK(payload.deleted.size() == 1001);
+    CHECK(ids(payload.deleted).back() == 5000);
+}
+
+TEST_CASE("Event batcher mode")
+{
+    std::stringstream ss;
+    ss << fty::EventBatcher::Mode::PerEvent;
+    CHECK(ss.str() == "per-event");
+
+    fty::EventBatcher::Mode mode = fty::EventBatcher::Mode::PerEvent;
+    std::stringstream("batch") >> mode;
+    CHECK(mode == fty::EventBatcher::Mode::Batch);
+
+    // Batching changes the wire format, legacy per-event messages are published unless batch is configured
+    fty::Config::Events events;
+    CHECK(events.mode == fty::EventBatcher::Mode::PerEvent);
+}
+
+struct Counter
+{
+    std::atomic<int> batches = 0;
+    std::atomic<int> events  = 0;
+
+    void event(const fty::Message& msg)
+    {
+        if (msg.meta.subject == fty::commands::notify::Batch) {
+            ++batches;
+        } else {
+            ++events;
+        }
+    }
+
+    void wait(const std::atomic<int>& value, int expected)
+    {
+        for (int i = 0; i < 100 && value < expected; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+};
+
+TEST_CASE("Event batcher")
+{
+    fty::MessageBus publisher;
+    REQUIRE(publisher.init("event-batcher-test"));
+
+    Counter         counter;
+    fty::MessageBus listener;
+    REQUIRE(listener.init("event-batcher-listener"));
+    REQUIRE(listener.subsribe(fty::Events, &Counter::event, &counter));
+
+    auto& batcher = fty::EventBatcher::instance();
+
+    // Bulk delete is published as one message
+    batcher.start(publisher, fty::EventBatcher::Mode::Batch, std::chrono::milliseconds(50));
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        batcher.notify(fty::commands::notify::Deleted, id);
+    }
+    counter.wait(counter.batches, 1);
+    CHECK(counter.batches == 1);
+    CHECK(counter.events == 0);
+
+    // Legacy mode
+    batcher.start(publisher, fty::EventBatcher::Mode::PerEvent, std::chrono::milliseconds(50));
+    for (uint64_t id = 1; id <= 3; ++id) {
+        batcher.notify(fty::commands::notify::Deleted, id);
+    }
+    counter.wait(counter.events, 3);
+    CHECK(counter.events == 3);
+    CHECK(counter.batches == 1);
+
+    batcher.stop();
+}
@@ -0,0 +1,172 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "lib/executor.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <fty/thread-pool.h>
+#include <thread>
+
+TEST_CASE("Executor")
+{
+    SECTION("runs all jobs")
+    {
+        std::atomic<int> run = 0;
+        {
+            fty::Executor executor(4);
+            CHECK(executor.workers() == 4);
+            for (int i = 0; i < 1000; ++i) {
+                executor.push([&]() {
+                    ++run;
+                });
+            }
+            executor.stop();
+            CHECK(executor.depth() == 0);
+        }
+        CHECK(run == 1000);
+    }
+
+    SECTION("jobs pushed from worker")
+    {
+        std::atomic<int> run = 0;
+        fty::Executor    executor(2);
+        executor.push([&]() {
+            for (int i = 0; i < 100; ++i) {
+                executor.push([&]() {
+                    ++run;
+                });
+            }
+        });
+
+        for (int i = 0; i < 100 && run < 100; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        executor.stop();
+        CHECK(run == 100);
+    }
+
+    SECTION("idle worker steals")
+    {
+        std::promise<void> release;
+        auto               released = release.get_future().share();
+        std::atomic<int>   run      = 0;
+
+        fty::Executor executor(2);
+        // Worker which got the blocking job has its following jobs stolen by the other one
+        executor.push([&]() {
+            for (int i = 0; i < 10; ++i) {
+                executor.push([&]() {
+                    ++run;
+                });
+            }
+            released.wait();
+        });
+
+        for (int i = 0; i < 100 && run < 10; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CHECK(run == 10);
+        CHECK(executor.stolen() >= 10);
+
+        release.set_value();
+        executor.stop();
+    }
+
+    SECTION("pinned workers")
+    {
+        std::atomic<int> run = 0;
+        fty::Executor    executor(2, {0});
+        executor.push([&]() {
+            ++run;
+        });
+        executor.stop();
+        CHECK(run == 1);
+    }
+
+    SECTION("push after stop")
+    {
+        bool          run = false;
+        fty::Executor executor(1);
+        executor.stop();
+        executor.push([&]() {
+            run = true;
+        });
+        CHECK(!run);
+    }
+}
+
+// =====================================================================================================================
+// Background jobs as the executor runs them: asset events are short and frequent, membership refresh is ten times
+// longer and rarer. Several bus threads push at once. Requests (READ, RESOLVE, ...) run in lanes, not here.
+
+static void spin(std::chrono::microseconds time)
+{
+    auto until = std::chrono::steady_clock::now() + time;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+class Background : public fty::Task<Background>
+{
+public:
+    Background(bool refresh, std::atomic<int>& left, std::promise<void>& done)
+        : m_refresh(refresh)
+        , m_left(left)
+        , m_done(done)
+    {
+    }
+
+    void operator()() override
+    {
+        spin(std::chrono::microseconds(m_refresh ? 200 : 20));
+        if (--m_left == 0) {
+            m_done.set_value();
+        }
+    }
+
+private:
+    bool                m_refresh;
+    std::atomic<int>&   m_left;
+    std::promise<void>& m_done;
+};
+
+template <typename Pool>
+static void mixedLoad(Pool& pool)
+{
+    static constexpr int Producers = 4;
+    static constexpr int Jobs      = 2000;
+
+    std::promise<void> done;
+    std::atomic<int>   left = Producers * Jobs;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers.emplace_back([&]() {
+            for (int i = 0; i < Jobs; ++i) {
+                pool.template pushWorker<Background>(i % 10 == 0, left, done);
+            }
+        });
+    }
+    for (auto& th : producers) {
+        th.join();
+    }
+    done.get_future().wait();
+}
+
+TEST_CASE("Executor background jobs benchmark", "[.][benchmark]")
+{
+    fty::ThreadPool pool;
+    fty::Executor   executor;
+
+    BENCHMARK("fty::ThreadPool, mixed background jobs")
+    {
+        mixedLoad(pool);
+    };
+
+    BENCHMARK("work-stealing Executor, mixed background jobs")
+    {
+        mixedLoad(executor);
+    };
+
+    pool.stop();
+}
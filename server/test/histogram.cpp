@@ -0,0 +1,56 @@
+#include "lib/histogram.h"
+#include "lib/request-stats.h"
+#include <catch2/catch.hpp>
+#include <random>
+
+TEST_CASE("Histogram")
+{
+    fty::Histogram hist;
+    CHECK(hist.count() == 0);
+    CHECK(hist.percentile(99) == 0);
+
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        hist.record(i);
+    }
+
+    CHECK(hist.count() == 10000);
+    CHECK(hist.min() == 1);
+    CHECK(hist.max() == 10000);
+    CHECK(hist.mean() == Approx(5000.5));
+
+    // Buckets keep relative error below 1/16
+    for (double percent : {1., 50., 90., 99., 99.9}) {
+        double expected = percent * 100;
+        CHECK(double(hist.percentile(percent)) >= expected);
+        CHECK(double(hist.percentile(percent)) <= expected * (1 + 1. / 16));
+    }
+    CHECK(hist.percentile(100) == 10000);
+
+    hist.record(fty::Histogram::MaxValue * 2);
+    CHECK(hist.max() == fty::Histogram::MaxValue);
+
+    hist.reset();
+    CHECK(hist.count() == 0);
+    CHECK(hist.max() == 0);
+}
+
+TEST_CASE("Request stats")
+{
+    auto& stats = fty::RequestStats::instance();
+    CHECK(stats.timings("UNKNOWN") == nullptr);
+
+    auto* read = stats.timings(fty::commands::read::Subject);
+    REQUIRE(read);
+    (*read)[fty::RequestStats::Stage::Run].record(std::chrono::milliseconds(2));
+
+    bool found = false;
+    for (const auto& answer : stats.report()) {
+        CHECK(answer.stages.size() == size_t(fty::RequestStats::Stage::Count));
+        if (answer.subject == fty::commands::read::Subject) {
+            found = true;
+            CHECK(answer.stages[2].name == "run");
+            CHECK(answer.stages[2].count.value() >= 1);
+        }
+    }
+    CHECK(found);
+}
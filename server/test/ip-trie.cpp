@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "lib/ip-trie.h"
+#include <catch2/catch.hpp>
+#include <random>
+
+static fty::IpTrie trie(const std::string& pattern)
+{
+    fty::IpTrie ret;
+    auto        networks = fty::IpTrie::parse(pattern);
+    REQUIRE(networks);
+    for (const auto& network : *networks) {
+        ret.insert(network);
+    }
+    return ret;
+}
+
+TEST_CASE("Ip trie")
+{
+    SECTION("parse")
+    {
+        CHECK(fty::IpTrie::address("10.0.0.1") == 0x0a000001u);
+        CHECK(!fty::IpTrie::address("10.0.0"));
+        CHECK(!fty::IpTrie::address("10.0.0.256"));
+        CHECK(!fty::IpTrie::address("fe80::1"));
+
+        CHECK(!fty::IpTrie::parse("10.1*"));
+        CHECK(!fty::IpTrie::parse("10.0.0.0/33"));
+        CHECK(!fty::IpTrie::parse("10.0.0.2-10.0.0.1"));
+        CHECK(fty::IpTrie::parse("10.0.0.0-10.0.0.255")->size() == 1);
+        CHECK(fty::IpTrie::parse("10.0.0.1-10.0.0.6")->size() == 4);
+    }
+
+    SECTION("address")
+    {
+        auto ip = trie("10.0.0.1");
+        CHECK(ip.match("10.0.0.1"));
+        CHECK(!ip.match("10.0.0.2"));
+        CHECK(!ip.match("fe80::1"));
+    }
+
+    SECTION("network")
+    {
+        auto net = trie("192.168.0.0/23");
+        CHECK(net.match("192.168.0.1"));
+        CHECK(net.match("192.168.1.255"));
+        CHECK(!net.match("192.168.2.0"));
+
+        CHECK(trie("0.0.0.0/0").match("1.2.3.4"));
+    }
+
+    SECTION("range")
+    {
+        auto range = trie("10.0.0.250-10.0.1.5");
+        CHECK(!range.match("10.0.0.249"));
+        CHECK(range.match("10.0.0.250"));
+        CHECK(range.match("10.0.1.0"));
+        CHECK(range.match("10.0.1.5"));
+        CHECK(!range.match("10.0.1.6"));
+    }
+
+    SECTION("wildcard")
+    {
+        auto wildcard = trie("127.0.*");
+        CHECK(wildcard.match("127.0.10.1"));
+        CHECK(!wildcard.match("127.1.0.1"));
+        CHECK(trie("*").match("1.2.3.4"));
+    }
+}
+
+TEST_CASE("Ip trie benchmark", "[.][benchmark]")
+{
+    std::mt19937                            gen(42);
+    std::uniform_int_distribution<uint32_t> dist;
+
+    fty::IpTrie trie;
+    for (int i = 0; i < 10000; ++i) {
+        trie.insert({dist(gen), uint8_t(16 + i % 17)});
+    }
+
+    std::vector<uint32_t> addresses;
+    for (int i = 0; i < 10000; ++i) {
+        addresses.push_back(dist(gen));
+    }
+
+    BENCHMARK("match 10000 addresses against 10000 networks")
+    {
+        size_t cnt = 0;
+        for (uint32_t addr : addresses) {
+            cnt += trie.match(addr);
+        }
+        return cnt;
+    };
+}
@@ -0,0 +1,215 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "lib/lane.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <fty/thread-pool.h>
+#include <future>
+#include <thread>
+
+TEST_CASE("Lane")
+{
+    SECTION("queue bound")
+    {
+        std::promise<void> release;
+        auto               released = release.get_future().share();
+
+        fty::Lane lane("slow", 1, 2);
+        CHECK(lane.queueSize() == 2);
+
+        std::promise<void> started;
+        REQUIRE(lane.push([&]() {
+            started.set_value();
+            released.wait();
+        }));
+        started.get_future().wait();
+
+        // Worker is busy, so following jobs are waiting in queue
+        CHECK(lane.push([]() {}));
+        CHECK(lane.push([]() {}));
+        CHECK(lane.depth() == 2);
+        CHECK(!lane.push([]() {}));
+
+        release.set_value();
+        lane.stop();
+        CHECK(lane.depth() == 0);
+        CHECK(!lane.push([]() {}));
+    }
+
+    SECTION("shed oldest")
+    {
+        std::promise<void> release;
+        auto               released = release.get_future().share();
+
+        fty::Lane lane("slow", 1, 2, fty::Lane::Policy::ShedOldest);
+
+        std::promise<void> started;
+        REQUIRE(lane.push([&]() {
+            started.set_value();
+            released.wait();
+        }));
+        started.get_future().wait();
+
+        std::atomic<int> run      = 0;
+        std::atomic<int> rejected = 0;
+        for (int i = 0; i < 5; ++i) {
+            CHECK(lane.push(
+                [&]() {
+                    ++run;
+                },
+                [&]() {
+                    ++rejected;
+                }));
+        }
+        CHECK(rejected == 3);
+        CHECK(lane.rejected() == 3);
+
+        release.set_value();
+        lane.stop();
+        CHECK(run == 2);
+    }
+
+    SECTION("max wait")
+    {
+        std::promise<void> release;
+        auto               released = release.get_future().share();
+
+        fty::Lane lane("slow", 1, 0, fty::Lane::Policy::Reject, std::chrono::milliseconds(10));
+
+        std::promise<void> started;
+        REQUIRE(lane.push([&]() {
+            started.set_value();
+            released.wait();
+        }));
+        started.get_future().wait();
+
+        std::atomic<bool> run      = false;
+        std::atomic<bool> rejected = false;
+        REQUIRE(lane.push(
+            [&]() {
+                run = true;
+            },
+            [&]() {
+                rejected = true;
+            }));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        release.set_value();
+        lane.stop();
+        CHECK(!run);
+        CHECK(rejected);
+    }
+
+    SECTION("lanes are independent")
+    {
+        std::promise<void> release;
+        auto               released = release.get_future().share();
+
+        fty::Lane slow("slow", 1, 0);
+        fty::Lane fast("fast", 1, 0);
+
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(slow.push([=]() {
+                released.wait();
+            }));
+        }
+
+        std::promise<void> done;
+        auto               fut = done.get_future();
+        REQUIRE(fast.push([&]() {
+            done.set_value();
+        }));
+        CHECK(fut.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        CHECK(slow.depth() >= 9);
+
+        release.set_value();
+    }
+}
+
+// =====================================================================================================================
+// Mixed request load: READ is short and frequent, RESOLVE is ten times longer and rarer. Several bus threads push at
+// once, as the bus listener and REST do. Baseline is the former request pool: one fty::ThreadPool with shared queue.
+
+static void spin(std::chrono::microseconds time)
+{
+    auto until = std::chrono::steady_clock::now() + time;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+namespace {
+
+class Request : public fty::Task<Request>
+{
+public:
+    Request(bool resolve, std::atomic<int>& left, std::promise<void>& done)
+        : m_resolve(resolve)
+        , m_left(left)
+        , m_done(done)
+    {
+    }
+
+    void operator()() override
+    {
+        spin(std::chrono::microseconds(m_resolve ? 200 : 20));
+        if (--m_left == 0) {
+            m_done.set_value();
+        }
+    }
+
+private:
+    bool                m_resolve;
+    std::atomic<int>&   m_left;
+    std::promise<void>& m_done;
+};
+
+} // namespace
+
+template <typename Push>
+static void mixedLoad(Push&& push)
+{
+    static constexpr int Producers = 4;
+    static constexpr int Requests  = 2000;
+
+    std::promise<void> done;
+    std::atomic<int>   left = Producers * Requests;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers.emplace_back([&]() {
+            for (int i = 0; i < Requests; ++i) {
+                push(i % 10 == 0, left, done);
+            }
+        });
+    }
+    for (auto& th : producers) {
+        th.join();
+    }
+    done.get_future().wait();
+}
+
+TEST_CASE("Lane benchmark", "[.][benchmark]")
+{
+    fty::ThreadPool pool;
+
+    // Lanes as shipped in agroup.conf, with unlimited queues so nothing is rejected
+    fty::Lane read("default", 4, 0);
+    fty::Lane resolve("resolve", 4, 0);
+
+    BENCHMARK("fty::ThreadPool, mixed READ/RESOLVE")
+    {
+        mixedLoad([&](bool isResolve, std::atomic<int>& left, std::promise<void>& done) {
+            pool.pushWorker<Request>(isResolve, left, done);
+        });
+    };
+
+    BENCHMARK("lanes on work-stealing executors, mixed READ/RESOLVE")
+    {
+        mixedLoad([&](bool isResolve, std::atomic<int>& left, std::promise<void>& done) {
+            auto& lane = isResolve ? resolve : read;
+            [[maybe_unused]] bool admitted = lane.pushWorker<Request>({}, isResolve, left, done);
+        });
+    };
+
+    pool.stop();
+}
@@ -0,0 +1,134 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "common/logger.h"
+#include "common/ring-buffer.h"
+#include <catch2/catch.hpp>
+#include <set>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+TEST_CASE("Ring buffer")
+{
+    SECTION("bounded")
+    {
+        fty::RingBuffer<int> buffer(5);
+        CHECK(buffer.capacity() == 8);
+
+        for (int i = 0; i < 8; ++i) {
+            CHECK(buffer.push(int(i)));
+        }
+        CHECK(!buffer.push(8));
+
+        for (int i = 0; i < 8; ++i) {
+            auto val = buffer.pop();
+            REQUIRE(val);
+            CHECK(*val == i);
+        }
+        CHECK(!buffer.pop());
+        CHECK(buffer.push(8));
+    }
+
+    SECTION("concurrent producers")
+    {
+        static constexpr int Producers = 4;
+        static constexpr int Count     = 10000;
+
+        fty::RingBuffer<int>     buffer(64);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < Producers; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < Count; ++i) {
+                    while (!buffer.push(p * Count + i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        std::set<int> received;
+        while (received.size() < Producers * Count) {
+            if (auto val = buffer.pop()) {
+                CHECK(received.insert(*val).second);
+            }
+        }
+        for (auto& th : producers) {
+            th.join();
+        }
+        CHECK(!buffer.pop());
+    }
+}
+
+static std::string expensive(bool& called)
+{
+    called = true;
+    return std::string(1024, 'x');
+}
+
+TEST_CASE("Lazy logging")
+{
+    bool called = false;
+
+    ftylog_getInstance()->setLogLevelInfo();
+    logDebug("Payload {}", expensive(called));
+    CHECK(!called);
+
+    ftylog_getInstance()->setLogLevelDebug();
+    logDebug("Payload {}", expensive(called));
+    CHECK(called);
+
+    fty::logger::flush();
+}
+
+TEST_CASE("Logging after fork")
+{
+    // Lines are written while the process forks, so sink could hold its mutex or wait on its condition at that moment
+    std::atomic<bool>        stop = false;
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&]() {
+            while (!stop) {
+                logInfo("Before fork");
+            }
+        });
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        pid_t pid = fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            // Deadlocked child is killed by the alarm
+            alarm(10);
+            logInfo("In child");
+            fty::logger::flush();
+            _exit(0);
+        }
+
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status));
+    }
+
+    stop = true;
+    for (auto& th : writers) {
+        th.join();
+    }
+    fty::logger::flush();
+}
+
+TEST_CASE("Lazy logging benchmark", "[.][benchmark]")
+{
+    std::string payload(4096, 'x');
+    ftylog_getInstance()->setLogLevelInfo();
+
+    BENCHMARK("disabled logDebug of 4KB payload")
+    {
+        logDebug("Payload {}", payload);
+    };
+
+    BENCHMARK("formatting of 4KB payload")
+    {
+        return fty::logger::format("Payload {}", payload);
+    };
+
+    ftylog_getInstance()->setLogLevelDebug();
+}
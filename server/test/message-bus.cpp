@@ -0,0 +1,79 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "common/message-bus.h"
+#include <catch2/catch.hpp>
+#include <thread>
+
+TEST_CASE("Mpsc queue")
+{
+    static constexpr size_t Producers = 8;
+    static constexpr size_t Count     = 10000;
+
+    fty::MpscQueue<std::pair<size_t, size_t>> queue;
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < Producers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (size_t i = 0; i < Count; ++i) {
+                queue.push({p, i});
+            }
+        });
+    }
+
+    // Messages of every producer are received in order
+    std::vector<size_t> next(Producers, 0);
+    size_t              received = 0;
+    while (received < Producers * Count) {
+        if (auto it = queue.pop()) {
+            REQUIRE(it->second == next[it->first]);
+            ++next[it->first];
+            ++received;
+        }
+    }
+
+    for (auto& th : producers) {
+        th.join();
+    }
+    CHECK(!queue.pop());
+}
+
+TEST_CASE("Message bus throughput", "[.][benchmark]")
+{
+    static constexpr size_t Messages = 10000;
+
+    fty::MessageBus bus;
+    REQUIRE(bus.init("bench-publisher"));
+
+    std::atomic<size_t> errors = 0;
+
+    auto publish = [&](size_t workers) {
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&]() {
+                for (size_t i = 0; i < Messages / workers; ++i) {
+                    fty::Message msg;
+                    msg.meta.subject = "bench";
+                    msg.userData.setString("payload");
+                    if (!bus.publish("BENCH.T.AGROUP", msg)) {
+                        ++errors;
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        return threads.size();
+    };
+
+    BENCHMARK("publish 10000 messages, 8 workers")
+    {
+        return publish(8);
+    };
+
+    BENCHMARK("publish 10000 messages, 32 workers")
+    {
+        return publish(32);
+    };
+
+    CHECK(errors == 0);
+}
@@ -0,0 +1,154 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "common/message.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fty_common_messagebus_message.h>
+#include <new>
+
+// =====================================================================================================================
+// Allocation counting. Allocations are only counted on the thread which runs countAllocations() and only while it runs,
+// the rest of the test binary just goes through to malloc.
+
+struct Allocations
+{
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+static thread_local Allocations* t_allocations = nullptr;
+
+void* operator new(size_t size)
+{
+    if (t_allocations) {
+        ++t_allocations->count;
+        t_allocations->bytes += size;
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+template <typename Func>
+static Allocations countAllocations(Func&& func)
+{
+    Allocations ret;
+    t_allocations = &ret;
+    func();
+    t_allocations = nullptr;
+    return ret;
+}
+
+// =====================================================================================================================
+
+static messagebus::Message busMessage(size_t payloadSize)
+{
+    messagebus::Message msg;
+    msg.userData().emplace_back(std::string(payloadSize, 'x'));
+    msg.metaData()[messagebus::Message::SUBJECT]        = "CREATE";
+    msg.metaData()[messagebus::Message::FROM]           = "automatic_group_rest";
+    msg.metaData()[messagebus::Message::TO]             = "automatic-group";
+    msg.metaData()[messagebus::Message::CORRELATION_ID] = "7c4a8d09-ca37-4b3f-9c1e-1d2f3e4a5b6c";
+    return msg;
+}
+
+TEST_CASE("Message move")
+{
+    auto              source = busMessage(1024);
+    fty::Message      moved(std::move(source));
+    const std::string subject = moved.meta.subject;
+    CHECK(subject == "CREATE");
+    CHECK(moved.userData.asString().size() == 1024);
+
+    fty::Message copied(busMessage(16));
+    CHECK(copied.meta.correlationId.value() == "7c4a8d09-ca37-4b3f-9c1e-1d2f3e4a5b6c");
+}
+
+TEST_CASE("Message to bus")
+{
+    fty::Message msg(busMessage(1024));
+
+    auto copied = msg.toMessageBus();
+    CHECK(copied.userData().front().size() == 1024);
+    CHECK(copied.metaData()[messagebus::Message::SUBJECT] == "CREATE");
+
+    auto moved = std::move(msg).toMessageBus();
+    CHECK(moved.userData().front().size() == 1024);
+    CHECK(moved.metaData()[messagebus::Message::CORRELATION_ID] == "7c4a8d09-ca37-4b3f-9c1e-1d2f3e4a5b6c");
+}
+
+TEST_CASE("Message encoding")
+{
+    // Peers which do not send encoding are treated as json ones
+    fty::Message plain(busMessage(16));
+    CHECK(plain.meta.encoding == fty::Message::Encoding::Json);
+
+    fty::Message binary(busMessage(16));
+    binary.meta.encoding = fty::Message::Encoding::Binary;
+
+    auto bus = binary.toMessageBus();
+    CHECK(bus.metaData()[fty::Message::EncodingKey] == "binary");
+
+    fty::Message received(std::move(bus));
+    CHECK(received.meta.encoding == fty::Message::Encoding::Binary);
+}
+
+TEST_CASE("Message allocations", "[.][benchmark]")
+{
+    static constexpr size_t PayloadSize = 1024 * 1024;
+
+    // Request as it goes from the bus listener to the job: bus message -> fty::Message -> job
+    auto copied = countAllocations([]() {
+        const auto   bus = busMessage(PayloadSize);
+        fty::Message msg(bus);
+        fty::Message job(msg);
+    });
+
+    auto moved = countAllocations([]() {
+        auto         bus = busMessage(PayloadSize);
+        fty::Message msg(std::move(bus));
+        fty::Message job(std::move(msg));
+    });
+
+    // Reply as it goes from the job to the outbound queue
+    auto copiedReply = countAllocations([]() {
+        fty::Message answer(busMessage(PayloadSize));
+        auto         bus = answer.toMessageBus();
+    });
+
+    auto movedReply = countAllocations([]() {
+        fty::Message answer(busMessage(PayloadSize));
+        auto         bus = std::move(answer).toMessageBus();
+    });
+
+    WARN("copy path: " << copied.count << " allocations, " << copied.bytes << " bytes");
+    WARN("move path: " << moved.count << " allocations, " << moved.bytes << " bytes");
+    WARN("copy reply: " << copiedReply.count << " allocations, " << copiedReply.bytes << " bytes");
+    WARN("move reply: " << movedReply.count << " allocations, " << movedReply.bytes << " bytes");
+    CHECK(moved.bytes <= copied.bytes);
+    CHECK(movedReply.bytes <= copiedReply.bytes);
+
+    BENCHMARK("copy 1MB request to job")
+    {
+        const auto   bus = busMessage(PayloadSize);
+        fty::Message msg(bus);
+        return fty::Message(msg);
+    };
+
+    BENCHMARK("move 1MB request to job")
+    {
+        auto         bus = busMessage(PayloadSize);
+        fty::Message msg(std::move(bus));
+        return fty::Message(std::move(msg));
+    };
+}
@@ -0,0 +1,50 @@
+#include "lib/executor.h"
+#include "lib/lane.h"
+#include "lib/metrics.h"
+#include "lib/request-stats.h"
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+TEST_CASE("Metrics")
+{
+    auto* read = fty::RequestStats::instance().timings(fty::commands::read::Subject);
+    REQUIRE(read);
+    (*read)[fty::RequestStats::Stage::Total].record(std::chrono::milliseconds(3));
+    fty::Metrics::instance().dbQuery.record(std::chrono::milliseconds(1));
+
+    std::vector<std::unique_ptr<fty::Lane>> lanes;
+    lanes.push_back(std::make_unique<fty::Lane>("resolve", 1, 10));
+    fty::Executor pool(1);
+
+    std::string text = fty::Metrics::instance().render(lanes, pool);
+    CHECK(text.find("# TYPE agroup_requests_total counter") != std::string::npos);
+    CHECK(text.find("agroup_requests_total{subject=\"READ\"} ") != std::string::npos);
+    CHECK(text.find("agroup_request_duration_seconds{subject=\"READ\",quantile=\"0.99\"} ") != std::string::npos);
+    CHECK(text.find("agroup_lane_queue_depth{lane=\"resolve\"} 0") != std::string::npos);
+    CHECK(text.find("agroup_lane_queue_size{lane=\"resolve\"} 10") != std::string::npos);
+    CHECK(text.find("agroup_lane_stolen_total{lane=\"resolve\"} 0") != std::string::npos);
+    CHECK(text.find("agroup_pool_queue_depth 0") != std::string::npos);
+    CHECK(text.find("agroup_db_query_seconds_count ") != std::string::npos);
+    CHECK(text.find("agroup_groups ") != std::string::npos);
+    CHECK(text.find("# HELP agroup_coalesce_hit_ratio Part of READ, RESOLVE and READ_MANY") != std::string::npos);
+
+    // Unique path, so parallel runs of the tests do not share the file
+    auto path = (std::filesystem::temp_directory_path() / fmt::format("agroup-metrics.{}.prom", getpid())).string();
+    {
+        fty::MetricsExporter exporter(path, std::chrono::seconds(60), [&]() {
+            return fty::Metrics::instance().render(lanes, pool);
+        });
+        REQUIRE(exporter.write());
+    }
+
+    std::ifstream     file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    CHECK(content.str().find("agroup_lane_queue_depth{lane=\"resolve\"}") != std::string::npos);
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+    std::filesystem::remove(path);
+}
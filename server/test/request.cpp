@@ -1,6 +1,8 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "common/commands.h"
 #include "common/message-bus.h"
 #include "lib/config.h"
+#include "lib/membership.h"
 #include "lib/server.h"
 #include "test-utils.h"
 #include "common/logger.h"
@@ -63,12 +65,13 @@ public:
         }
     }
 
-    fty::commands::resolve::Out resolve(fty::MessageBus& bus)
+    fty::commands::resolve::Out resolve(fty::MessageBus& bus, bool details = false)
     {
         fty::Message msg = message(fty::commands::resolve::Subject);
 
         fty::commands::resolve::In in;
-        in.id = id;
+        in.id      = id;
+        in.details = details;
 
         msg.userData.setString(*pack::json::serialize(in));
         auto ret = bus.send(fty::Channel, msg);
@@ -133,7 +136,7 @@ public:
         return *info;
     }
 
-private:
+public:
     static fty::Message message(const std::string& subj)
     {
         fty::Message msg;
@@ -277,6 +280,20 @@ static void testSimpleGroup(fty::MessageBus& bus)
     CHECK(res[0].name == "srv1");
     CHECK(res[1].name == "srv2");
     CHECK(res[2].name == "srv3");
+    CHECK(res[0].type.empty());
+
+    // resolve group with details
+    auto details = group.resolve(bus, true);
+    REQUIRE(details.size() == 3);
+    CHECK(details[0].name == "srv1");
+    CHECK(details[0].type == "device");
+    CHECK(details[0].subType == "server");
+    CHECK(details[0].status == "active");
+    CHECK(details[0].priority == 1);
+    REQUIRE(details[0].locations.size() == 1);
+    CHECK(details[0].locations[0].name == "datacenter");
+    CHECK(details[0].locations[0].type == "datacenter");
+    CHECK(details[0].powers.empty());
 
     // Delete group
     group.remove(bus);
@@ -772,6 +789,365 @@ static void testByIpAddress(fty::MessageBus& bus)
     group.remove(bus);
 }
 
+static void testMembershipTable(fty::MessageBus& bus)
+{
+    fty::Config::instance().membershipTable = true;
+    REQUIRE(fty::Membership::refresh());
+    CHECK(fty::Membership::ready());
+
+    Group group;
+    group.name          = "Membership";
+    group.rules.groupOp = fty::Group::LogicalOp::And;
+
+    {
+        auto& var  = group.rules.conditions.append();
+        auto& cond = var.reset<fty::Group::Condition>();
+        cond.value = "datacenter1";
+        cond.field = fty::Group::Fields::Location;
+        cond.op    = fty::Group::ConditionOp::Is;
+    }
+    group.create(bus);
+
+    {
+        auto info = group.resolve(bus);
+        REQUIRE(info.size() == 2);
+        CHECK(info[0].name == "srv11");
+        CHECK(info[1].name == "srv21");
+    }
+
+    {
+        auto& cond = group.rules.conditions[0].get<fty::Group::Condition>();
+        cond.value = "srv";
+        cond.field = fty::Group::Fields::Name;
+        cond.op    = fty::Group::ConditionOp::Contains;
+        group.update(bus);
+
+        auto info = group.resolve(bus);
+        REQUIRE(info.size() == 5);
+        CHECK(info[0].name == "srv1");
+        CHECK(info[4].name == "srv21");
+    }
+
+    group.remove(bus);
+    fty::Config::instance().membershipTable = false;
+}
+
+static fty::commands::membership::Out membershipOf(fty::MessageBus& bus, uint64_t assetId)
+{
+    fty::Message msg;
+    msg.meta.to      = fty::Config::instance().actorName;
+    msg.meta.subject = fty::commands::membership::Subject;
+    msg.meta.from    = "unit-test";
+
+    fty::commands::membership::In in;
+    in.id = assetId;
+    msg.userData.setString(*pack::json::serialize(in));
+
+    auto ret = bus.send(fty::Channel, msg);
+    if (!ret) {
+        FAIL(ret.error());
+    }
+
+    auto info = ret->userData.decode<fty::commands::membership::Out>();
+    if (!info) {
+        FAIL(info.error());
+    }
+    return *info;
+}
+
+static void testMembershipOf(fty::MessageBus& bus, const Test& test)
+{
+    REQUIRE(fty::Membership::refresh());
+
+    Group byName;
+    byName.name          = "MembershipOf name";
+    byName.rules.groupOp = fty::Group::LogicalOp::And;
+    {
+        auto& var  = byName.rules.conditions.append();
+        auto& cond = var.reset<fty::Group::Condition>();
+        cond.value = "srv1";
+        cond.field = fty::Group::Fields::Name;
+        cond.op    = fty::Group::ConditionOp::Contains;
+    }
+    byName.create(bus);
+
+    Group byLocation;
+    byLocation.name          = "MembershipOf location";
+    byLocation.rules.groupOp = fty::Group::LogicalOp::And;
+    {
+        auto& var  = byLocation.rules.conditions.append();
+        auto& cond = var.reset<fty::Group::Condition>();
+        cond.value = "datacenter1";
+        cond.field = fty::Group::Fields::Location;
+        cond.op    = fty::Group::ConditionOp::Is;
+    }
+    byLocation.create(bus);
+
+    {
+        auto info = membershipOf(bus, test.srv11->id);
+        REQUIRE(info.size() == 2);
+        CHECK(info[0].name == "MembershipOf name");
+        CHECK(info[1].name == "MembershipOf location");
+    }
+    {
+        auto info = membershipOf(bus, test.srv21->id);
+        REQUIRE(info.size() == 1);
+        CHECK(info[0].id == byLocation.id);
+    }
+    {
+        auto info = membershipOf(bus, test.srv2->id);
+        CHECK(info.size() == 0);
+    }
+
+    byName.remove(bus);
+    {
+        auto info = membershipOf(bus, test.srv11->id);
+        REQUIRE(info.size() == 1);
+        CHECK(info[0].id == byLocation.id);
+    }
+
+    byLocation.remove(bus);
+}
+
+static void testSendAsync(fty::MessageBus& bus)
+{
+    std::vector<Group> groups(10);
+    for (size_t i = 0; i < groups.size(); ++i) {
+        groups[i].name          = "Async " + std::to_string(i);
+        groups[i].rules.groupOp = fty::Group::LogicalOp::And;
+
+        auto& var  = groups[i].rules.conditions.append();
+        auto& cond = var.reset<fty::Group::Condition>();
+        cond.value = "srv";
+        cond.field = fty::Group::Fields::Name;
+        cond.op    = fty::Group::ConditionOp::Contains;
+
+        groups[i].create(bus);
+    }
+
+    // All requests are in flight at once, every reply must match its own request
+    std::vector<std::future<fty::Expected<fty::Message>>> replies;
+    for (const auto& group : groups) {
+        fty::Message msg = Group::message(fty::commands::read::Subject);
+
+        fty::commands::read::In in;
+        in.id = group.id;
+        msg.userData.setString(*pack::json::serialize(in));
+
+        replies.push_back(bus.sendAsync(fty::Channel, msg));
+    }
+
+    for (size_t i = 0; i < replies.size(); ++i) {
+        auto ret = replies[i].get();
+        REQUIRE(ret);
+        auto info = ret->userData.decode<fty::commands::read::Out>();
+        REQUIRE(info);
+        CHECK(info->id == groups[i].id);
+        CHECK(info->name == groups[i].name);
+    }
+
+    for (auto& group : groups) {
+        group.remove(bus);
+    }
+}
+
+static void testTimeouts()
+{
+    fty::MessageBus bus;
+    REQUIRE(bus.init("unit-test-timeouts"));
+    CHECK(bus.connected());
+
+    auto timeout = [&]() {
+        fty::Message msg = Group::message(fty::commands::read::Subject);
+        msg.meta.to      = "nobody";
+        return bus.sendAsync("FTY.Q.NOBODY", msg, std::chrono::milliseconds(100)).get();
+    };
+
+    // Served request resets the count of timeouts
+    for (size_t i = 0; i + 1 < fty::MessageBus::MaxTimeouts; ++i) {
+        CHECK(!timeout());
+    }
+    Group::list(bus);
+    CHECK(!timeout());
+    CHECK(bus.connected());
+
+    for (size_t i = 0; i < fty::MessageBus::MaxTimeouts; ++i) {
+        CHECK(!timeout());
+    }
+    CHECK(!bus.connected());
+}
+
+static fty::commands::readMany::Out readMany(fty::MessageBus& bus, const fty::commands::readMany::In& in)
+{
+    fty::Message msg = Group::message(fty::commands::readMany::Subject);
+    msg.userData.setString(*pack::json::serialize(in));
+
+    auto ret = bus.send(fty::Channel, msg);
+    if (!ret) {
+        FAIL(ret.error());
+    }
+
+    auto info = ret->decode<fty::commands::readMany::Out>();
+    if (!info) {
+        FAIL(info.error());
+    }
+    return *info;
+}
+
+static std::vector<Group> createGroups(fty::MessageBus& bus, const std::string& prefix, size_t count)
+{
+    std::vector<Group> groups(count);
+    for (size_t i = 0; i < groups.size(); ++i) {
+        groups[i].name          = prefix + std::to_string(i);
+        groups[i].rules.groupOp = fty::Group::LogicalOp::And;
+
+        auto& var  = groups[i].rules.conditions.append();
+        auto& cond = var.reset<fty::Group::Condition>();
+        cond.value = "srv";
+        cond.field = fty::Group::Fields::Name;
+        cond.op    = fty::Group::ConditionOp::Contains;
+
+        groups[i].create(bus);
+    }
+    return groups;
+}
+
+static void testReadMany(fty::MessageBus& bus)
+{
+    auto groups = createGroups(bus, "Many ", 5);
+
+    fty::commands::readMany::In all;
+    all.all = true;
+    CHECK(readMany(bus, all).size() == Group::list(bus).size());
+
+    fty::commands::readMany::In some;
+    some.ids.append(groups[3].id.value());
+    some.ids.append(groups[1].id.value());
+    some.ids.append(999999);
+
+    auto info = readMany(bus, some);
+    REQUIRE(info.size() == 2);
+    CHECK(info[0].name == "Many 3");
+    CHECK(info[1].name == "Many 1");
+    CHECK(info[1].rules.conditions.size() == 1);
+
+    for (auto& group : groups) {
+        group.remove(bus);
+    }
+}
+
+static fty::Expected<fty::commands::resolve::Out> resolve(
+    fty::MessageBus& bus, const fty::commands::resolve::In& in)
+{
+    fty::Message msg = Group::message(fty::commands::resolve::Subject);
+    msg.userData.setString(*pack::json::serialize(in));
+
+    auto ret = bus.send(fty::Channel, msg);
+    if (!ret) {
+        return fty::unexpected(ret.error());
+    }
+    return ret->userData.decode<fty::commands::resolve::Out>();
+}
+
+static void testPaging(fty::MessageBus& bus)
+{
+    auto groups = createGroups(bus, "Page ", 3);
+
+    // Groups
+    fty::commands::readMany::In some;
+    for (const auto& group : groups) {
+        some.ids.append(group.id.value());
+    }
+    some.sort   = "-name";
+    some.offset = 1;
+    some.limit  = 1;
+    some.fields.append("name");
+
+    auto info = readMany(bus, some);
+    REQUIRE(info.size() == 1);
+    CHECK(info[0].name == "Page 1");
+    CHECK(info[0].rules.conditions.empty());
+
+    // Assets
+    fty::commands::resolve::In in;
+    in.id     = groups[0].id;
+    in.sort   = "-name";
+    in.offset = 1;
+    in.limit  = 2;
+
+    auto assets = resolve(bus, in);
+    REQUIRE(assets);
+    REQUIRE(assets->size() == 2);
+    CHECK((*assets)[0].name == "srv21");
+    CHECK((*assets)[1].name == "srv2");
+
+    in.details = true;
+    in.fields.append("status");
+    assets = resolve(bus, in);
+    REQUIRE(assets);
+    REQUIRE(assets->size() == 2);
+    CHECK((*assets)[0].status == "active");
+    CHECK((*assets)[0].type.empty());
+    CHECK((*assets)[0].locations.empty());
+
+    in.sort = "size";
+    CHECK(!resolve(bus, in));
+
+    // Total of all pages is counted by the daemon
+    fty::commands::resolveCount::In count;
+    count.id = groups[0].id;
+
+    fty::Message msg = Group::message(fty::commands::resolveCount::Subject);
+    msg.userData.setString(*pack::json::serialize(count));
+
+    auto ret = bus.send(fty::Channel, msg);
+    REQUIRE(ret);
+    auto total = ret->userData.decode<fty::commands::resolveCount::Out>();
+    REQUIRE(total);
+
+    fty::commands::resolve::In all;
+    all.id = groups[0].id;
+    assets = resolve(bus, all);
+    REQUIRE(assets);
+    CHECK(total->total == assets->size());
+    CHECK(total->total > 2);
+
+    for (auto& group : groups) {
+        group.remove(bus);
+    }
+}
+
+static fty::commands::version::Out version(fty::MessageBus& bus)
+{
+    auto ret = bus.send(fty::Channel, Group::message(fty::commands::version::Subject));
+    if (!ret) {
+        FAIL(ret.error());
+    }
+
+    auto info = ret->userData.decode<fty::commands::version::Out>();
+    if (!info) {
+        FAIL(info.error());
+    }
+    return *info;
+}
+
+static void testVersion(fty::MessageBus& bus)
+{
+    auto before = version(bus);
+    CHECK(before.generation > 0);
+    CHECK(version(bus).groups == before.groups);
+
+    auto groups = createGroups(bus, "Version ", 1);
+    auto after  = version(bus);
+    CHECK(after.generation == before.generation);
+    CHECK(after.groups > before.groups);
+    // Group matches assets, so its membership was evaluated
+    CHECK(after.assets > before.assets);
+
+    groups[0].remove(bus);
+    CHECK(version(bus).groups > after.groups);
+}
+
 // =====================================================================================================================
 
 TEST_CASE("Server request")
@@ -789,4 +1165,63 @@ TEST_CASE("Server request")
     testByHostName(test->bus);
     testByContact(test->bus);
     testByIpAddress(test->bus);
+    testMembershipTable(test->bus);
+    testMembershipOf(test->bus, *test);
+    testSendAsync(test->bus);
+    testTimeouts();
+    testReadMany(test->bus);
+    testVersion(test->bus);
+    testPaging(test->bus);
+}
+
+TEST_CASE("Read many benchmark", "[.][benchmark]")
+{
+    auto test = std::make_unique<Test>();
+    test->init();
+
+    auto groups = createGroups(test->bus, "Bench ", 2000);
+
+    // Former REST list: LIST and then READ of every group
+    auto listRead = [&]() {
+        size_t requests = 1;
+        for (const auto& it : Group::list(test->bus)) {
+            Group group;
+            group.id = it.id;
+            group.read(test->bus);
+            ++requests;
+        }
+        return requests;
+    };
+
+    auto readAll = [&]() {
+        fty::commands::readMany::In in;
+        in.all = true;
+        return readMany(test->bus, in).size();
+    };
+
+    // One pass of each path is summarized, so the comparison could be quoted without parsing benchmark tables
+    auto timed = [](auto&& func) {
+        auto start = std::chrono::steady_clock::now();
+        auto ret   = func();
+        return std::make_pair(ret, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start));
+    };
+    auto [requests, listReadTime] = timed(listRead);
+    auto [answered, readManyTime] = timed(readAll);
+    CHECK(answered >= groups.size());
+    WARN("LIST + READ: " << requests << " requests, " << listReadTime.count() << " ms");
+    WARN("READ_MANY: 1 request, " << readManyTime.count() << " ms for " << answered << " groups");
+
+    BENCHMARK("LIST + READ per group, 2000 groups")
+    {
+        return listRead();
+    };
+
+    BENCHMARK("READ_MANY, 2000 groups")
+    {
+        return readAll();
+    };
+
+    for (auto& group : groups) {
+        group.remove(test->bus);
+    }
 }
@@ -0,0 +1,87 @@
+#include "lib/single-flight.h"
+#include "lib/task.h"
+#include "common/commands.h"
+#include <catch2/catch.hpp>
+
+static fty::Message request(const std::string& subject, const std::string& payload, const std::string& from)
+{
+    fty::Message msg;
+    msg.meta.subject = subject;
+    msg.meta.from    = from;
+    msg.userData.setString(payload);
+    return msg;
+}
+
+TEST_CASE("Single flight")
+{
+    CHECK(fty::SingleFlight::coalesced(fty::commands::resolve::Subject));
+    CHECK(fty::SingleFlight::coalesced(fty::commands::read::Subject));
+    CHECK(!fty::SingleFlight::coalesced(fty::commands::create::Subject));
+
+    fty::SingleFlight flight;
+
+    auto leader = request(fty::commands::resolve::Subject, R"({"id": 1})", "tab1");
+    CHECK(!flight.join(leader));
+    CHECK(flight.join(request(fty::commands::resolve::Subject, R"({"id": 1})", "tab2")));
+    CHECK(flight.join(request(fty::commands::resolve::Subject, R"({"id": 1})", "tab3")));
+
+    // Different payload or subject is a different flight
+    CHECK(!flight.join(request(fty::commands::resolve::Subject, R"({"id": 2})", "tab4")));
+    CHECK(!flight.join(request(fty::commands::read::Subject, R"({"id": 1})", "tab5")));
+
+    // So is the same payload in other encoding, reply is encoded as the request
+    auto binary          = request(fty::commands::resolve::Subject, R"({"id": 1})", "tab6");
+    binary.meta.encoding = fty::Message::Encoding::Binary;
+    CHECK(!flight.join(binary));
+    CHECK(flight.finish(binary).empty());
+
+    auto followers = flight.finish(leader);
+    REQUIRE(followers.size() == 2);
+    CHECK(followers[0].meta.from == "tab2");
+    CHECK(followers[1].meta.from == "tab3");
+    CHECK(flight.finish(leader).empty());
+
+    // Flight is over, next request is run again
+    CHECK(!flight.join(leader));
+
+    CHECK(flight.hits() == 2);
+    CHECK(flight.misses() == 5);
+    CHECK(flight.hitRate() == Approx(2. / 7.));
+}
+
+// =====================================================================================================================
+
+namespace {
+
+/// Job which fails with an exception other than job::Error
+class Failing : public fty::job::Task<Failing, fty::commands::resolve::In, fty::commands::resolve::Out>
+{
+public:
+    using Task::Task;
+
+    void run(const fty::commands::resolve::In&, fty::commands::resolve::Out&)
+    {
+        throw std::runtime_error("database is gone");
+    }
+};
+
+} // namespace
+
+TEST_CASE("Single flight leader failure")
+{
+    auto& flight = fty::SingleFlight::instance();
+
+    auto leader = request(fty::commands::resolve::Subject, R"({"id": 42})", "tab1");
+    REQUIRE(!flight.join(leader));
+    REQUIRE(flight.join(request(fty::commands::resolve::Subject, R"({"id": 42})", "tab2")));
+
+    // Bus is not connected, so replies are only logged, but the flight must be over
+    fty::MessageBus bus;
+    Failing         job(leader, bus);
+    CHECK_NOTHROW(job());
+
+    // Follower was taken to be replied
+    CHECK(flight.finish(leader).empty());
+    CHECK(!flight.join(leader));
+    flight.finish(leader);
+}
@@ -0,0 +1,125 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "lib/search.h"
+#include "lib/string-column.h"
+#include <catch2/catch.hpp>
+#include <random>
+
+static std::string randomString(std::mt19937& gen, size_t size)
+{
+    static const char alphabet[] = "abcdefgh-._0123";
+
+    std::uniform_int_distribution<size_t> dist(0, sizeof(alphabet) - 2);
+    std::string                           ret;
+    for (size_t i = 0; i < size; ++i) {
+        ret.push_back(alphabet[dist(gen)]);
+    }
+    return ret;
+}
+
+static size_t count(std::string_view data, std::string_view needle, size_t (*find)(std::string_view, std::string_view))
+{
+    size_t cnt = 0;
+    for (size_t pos = find(data, needle); pos != std::string_view::npos; pos = find(data, needle)) {
+        ++cnt;
+        data = data.substr(pos + 1);
+    }
+    return cnt;
+}
+
+TEST_CASE("Search kernel")
+{
+    std::mt19937 gen(42);
+    std::string  haystack = randomString(gen, 10000);
+
+    INFO("kernel " << fty::search::kernel());
+    for (size_t len : {1, 2, 3, 5, 16, 17, 40}) {
+        for (int i = 0; i < 20; ++i) {
+            std::string needle = randomString(gen, len);
+            CHECK(count(haystack, needle, &fty::search::find) == count(haystack, needle, &fty::search::findScalar));
+        }
+    }
+
+    CHECK(fty::search::find("", "a") == std::string_view::npos);
+    CHECK(fty::search::find("abc", "") == 0);
+    CHECK(fty::search::find("abc", "abcd") == std::string_view::npos);
+    CHECK(fty::search::find(std::string(100, 'a') + "b", "ab") == 99);
+}
+
+TEST_CASE("String column")
+{
+    fty::StringColumn column;
+    column.add(1, "Server-1");
+    column.add(2, "server-2");
+    column.add(3, "ups");
+    column.add(2, "rack server");
+
+    CHECK(column.contains("server") == std::vector<uint64_t>{1, 2});
+    CHECK(column.contains("r-") == std::vector<uint64_t>{1, 2});
+    CHECK(column.contains("ups") == std::vector<uint64_t>{3});
+    CHECK(column.contains("1s").empty());
+
+    column.remove(2);
+    CHECK(column.contains("server") == std::vector<uint64_t>{1});
+
+    column.add(2, "srv");
+    CHECK(column.contains("s") == std::vector<uint64_t>{1, 2, 3});
+    CHECK(column.size() == 3);
+}
+
+TEST_CASE("String column trigrams")
+{
+    std::mt19937      gen(42);
+    fty::StringColumn column;
+    for (uint64_t id = 1; id <= 2000; ++id) {
+        column.add(id, randomString(gen, 4 + id % 20));
+    }
+    for (uint64_t id = 1; id <= 2000; id += 3) {
+        column.remove(id);
+    }
+
+    for (size_t len : {3, 4, 6, 10}) {
+        for (int i = 0; i < 20; ++i) {
+            std::string needle = randomString(gen, len);
+            CHECK(column.contains(needle) == column.scan(needle));
+        }
+    }
+
+    // Same trigram twice, but the value does not contain the needle
+    fty::StringColumn repeated;
+    repeated.add(1, "abcxabc");
+    CHECK(repeated.contains("abcabc").empty());
+    CHECK(repeated.contains("cxab") == std::vector<uint64_t>{1});
+}
+
+TEST_CASE("String column benchmark", "[.][benchmark]")
+{
+    std::mt19937      gen(42);
+    fty::StringColumn column;
+    std::string       data;
+    for (uint64_t id = 1; id <= 1000000; ++id) {
+        std::string value = randomString(gen, 8 + id % 24);
+        column.add(id, value);
+        data += value;
+        data.push_back('\0');
+    }
+
+    BENCHMARK("scalar search, 1M strings")
+    {
+        return count(data, "cafe.", &fty::search::findScalar);
+    };
+
+    BENCHMARK(std::string(fty::search::kernel()) + " search, 1M strings")
+    {
+        return count(data, "cafe.", &fty::search::find);
+    };
+
+    BENCHMARK("column scan, 1M strings")
+    {
+        return column.scan("cafe.");
+    };
+
+    BENCHMARK("column trigrams, 1M strings")
+    {
+        return column.contains("cafe.");
+    };
+}